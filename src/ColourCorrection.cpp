@@ -15,8 +15,13 @@
  *   - Grayscale Conversion: Transform color images into grayscale.
  *   - Brightness Adjustment: Modify the brightness of an image.
  *   - Histogram Equalization: Improve contrast using histogram equalization.
+ *   - CLAHE: Improve local contrast with contrast-limited adaptive histogram equalization.
  *   - Thresholding: Apply binary thresholding to images for segmentation purposes.
- *   - Salt and Pepper Noise: Introduce noise to an image for testing and simulation.
+ *   - Otsu Thresholding: Choose 1 to 3 thresholds automatically from the image histogram.
+ *   - Local Thresholding: Threshold each pixel against the mean (and deviation) of its window,
+ *     for unevenly lit images (mean-C, Bradley and Sauvola).
+ *   - Noise: Introduce salt and pepper, Gaussian or speckle noise for testing and simulation;
+ *     a seed reproduces the same noise on any number of threads.
  *
  * Usage:
  *   Image img = ...; // An instance of the Image class
@@ -32,12 +37,16 @@
  */
 
 #include "ColourCorrection.h"
+#include "Histogram.h"
+#include "Parallel.h"
+#include "Philox.h"
+#include "PointOperation.h"
+#include "SimdOps.h"
+#include "SummedAreaTable.h"
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <cmath>
-#include <cstring> // for std::memcpy
-#include <cstdlib> // for std::rand, std::srand
-#include <ctime>   // for std::time
 #include <iostream>
 
 
@@ -47,9 +56,25 @@
  * @param type The type of color correction to apply (e.g., grayscale, brightness adjustment).
  * @param param An integer parameter used for certain types of corrections (e.g., brightness value).
  * @param colorSpace The color space in which the correction is to be applied (e.g., RGB, HSV).
+ * @param tileGrid The number of tiles along each axis for CLAHE.
  */
-ColourCorrection::ColourCorrection(ColourCorrectionType type, int param, ColorSpace colorSpace)
-    : correctionType(type), parameter(param), colorSpace(colorSpace) {
+ColourCorrection::ColourCorrection(ColourCorrectionType type, int param, ColorSpace colorSpace, int tileGrid)
+    : correctionType(type), parameter(param), colorSpace(colorSpace), tileGrid(tileGrid),
+      sensitivity(type == MeanThresholding ? 5.0f : type == BradleyThresholding ? 15.0f : 0.2f),
+      seed(0), seedSet(false) {
+}
+
+/**
+ * Constructor: Constructs a local thresholding ColourCorrection object.
+ *
+ * @param type MeanThresholding, BradleyThresholding or SauvolaThresholding.
+ * @param windowSize The side of the window around each pixel (0 for one eighth of the smaller image side).
+ * @param sensitivity The constant C (mean-C), the percentage below the mean (Bradley) or k (Sauvola).
+ * @param colorSpace The color space whose V or L channel is thresholded in colour images.
+ */
+ColourCorrection::ColourCorrection(ColourCorrectionType type, int windowSize, float sensitivity, ColorSpace colorSpace)
+    : correctionType(type), parameter(windowSize), colorSpace(colorSpace), tileGrid(8), sensitivity(sensitivity),
+      seed(0), seedSet(false) {
 }
 
 /**
@@ -57,6 +82,19 @@ ColourCorrection::ColourCorrection(ColourCorrectionType type, int param, ColorSp
  */
 ColourCorrection::~ColourCorrection() {}
 
+/**
+ * Returns the seed of the noise generator, drawing a random one if none has been set, so that
+ * objects that never add noise do not draw a seed.
+ *
+ * @return The seed used by the noise types.
+ */
+uint64_t ColourCorrection::getSeed() {
+    if (!seedSet) {
+        setSeed(Philox::randomSeed());
+    }
+    return seed;
+}
+
 /**
  * Applies the specified color correction to an image.
  *
@@ -68,37 +106,44 @@ void ColourCorrection::apply(Image& image) {
     int height = image.getHeight();
     int channels = image.getChannels();
 
-    unsigned char* processedData = nullptr;
     switch (correctionType) {
     case Grayscale:
-        processedData = applyGrayscale(imgData, width, height, channels);
-        break;
+        // Grayscale will change the number of channels to 1
+        image.updateData(applyGrayscale(imgData, width, height, channels), width, height, 1);
+        return;
     case BrightnessAdjust:
-        processedData = adjustBrightness(imgData, width, height, channels, parameter);
-        break;
+        // Point operations map the image in place through a lookup table
+        adjustBrightness(imgData, width, height, channels, parameter);
+        return;
     case HistogramEqualization:
-        processedData = histogramEqualisation(imgData, width, height, channels, colorSpace);
-        break;
+        histogramEqualisation(imgData, width, height, channels, colorSpace);
+        return;
     case Thresholding:
-        processedData = applyThresholding(imgData, width, height, channels, static_cast<unsigned char>(parameter), colorSpace);
-        break;
+        applyThresholding(imgData, width, height, channels, static_cast<unsigned char>(parameter), colorSpace);
+        return;
     case SaltPepperNoise:
-        processedData = saltAndPepperNoise(imgData, width, height, channels, static_cast<float>(parameter));
-        break;
+        saltAndPepperNoise(imgData, width, height, channels, static_cast<float>(parameter), getSeed());
+        return;
+    case GaussianNoise:
+    case SpeckleNoise:
+        gaussianNoise(imgData, width, height, channels, correctionType == GaussianNoise ? parameter : parameter / 100.0f,
+                      correctionType == SpeckleNoise, getSeed());
+        return;
+    case CLAHE:
+        adaptiveEqualisation(imgData, width, height, channels, parameter > 0 ? parameter : 2, tileGrid, colorSpace);
+        return;
+    case OtsuThresholding:
+        thresholds = otsuThresholding(imgData, width, height, channels, parameter > 0 ? parameter : 2, colorSpace);
+        return;
+    case MeanThresholding:
+    case BradleyThresholding:
+    case SauvolaThresholding:
+        localThresholding(imgData, width, height, channels, correctionType, parameter, sensitivity, colorSpace);
+        return;
     default:
         std::cerr << "Unsupported colour correction type" << std::endl;
         return;
     }
-
-    if (correctionType == Grayscale) {
-        // Grayscale will change the number of channels to 1
-        image.updateData(processedData, width, height, 1);
-    }
-    else {
-        // For other corrections, the number of channels remains the same
-        std::memcpy(imgData, processedData, width * height * channels);
-        delete[] processedData;
-    }
 }
 
 /**
@@ -125,36 +170,34 @@ unsigned char* ColourCorrection::applyGrayscale(unsigned char* image, int width,
 }
 
 /**
- * Adjusts the brightness of an image.
+ * Adjusts the brightness of an image in place.
  *
  * @param image Pointer to the image data.
  * @param width Width of the image.
  * @param height Height of the image.
  * @param channels Number of color channels in the image.
  * @param brightness The brightness adjustment value (-256 for automatic adjustment).
- * @return Pointer to the brightness-adjusted image data.
  */
-unsigned char* ColourCorrection::adjustBrightness(unsigned char* image, int width, int height, int channels, int brightness) {
+void ColourCorrection::adjustBrightness(unsigned char* image, int width, int height, int channels, int brightness) {
     int img_size = width * height * channels;
-    unsigned char* adjusted_image = new unsigned char[img_size];
 
     // Automatic brightness adjustment (optional)
     if (brightness == -256) {
-        long totalBrightness = 0;
-        for (int i = 0; i < img_size; i += channels) {
-            // Calculate the perceived brightness
-            totalBrightness += 0.2126 * image[i] + 0.7152 * image[i + 1] + 0.0722 * image[i + 2];
+        // Mean of the perceived brightness, truncated per pixel; images without colour channels use their first channel
+        double meanBrightness;
+        if (channels >= 3) {
+            meanBrightness = Histogram::ofPixels(image, static_cast<std::size_t>(width) * height, channels, [](const unsigned char* px) {
+                return static_cast<int>(0.2126 * px[0] + 0.7152 * px[1] + 0.0722 * px[2]);
+            }).mean();
         }
-        brightness = 128 - static_cast<int>(totalBrightness / (width * height));
-    }
-
-    // Adjust brightness
-    for (int i = 0; i < img_size; i++) {
-        int newValue = static_cast<int>(image[i]) + brightness;
-        adjusted_image[i] = static_cast<unsigned char>(std::max(0, std::min(255, newValue)));
+        else {
+            meanBrightness = Histogram(image, static_cast<std::size_t>(width) * height, channels).mean();
+        }
+        brightness = 128 - static_cast<int>(meanBrightness);
     }
 
-    return adjusted_image;
+    // Adjust brightness of every byte, alpha included
+    PointOperation::brightness(brightness).map(image, img_size);
 }
 
 // Utility functions for RGB to HSV conversion and back
@@ -264,131 +307,544 @@ void hslToRgb(HSL hsl, unsigned char& r, unsigned char& g, unsigned char& b) {
     b = static_cast<unsigned char>(b_f * 255.0f);
 }
 
+// Pixels per work item of the colour equalisation remap
+static const std::size_t equalisationChunkPixels = 16 * 1024;
+
+// float(v) / 255 for every byte value, as rgbToHsv and rgbToHsl compute it
+static const float* unitLevels() {
+    static const std::array<float, 256> levels = [] {
+        std::array<float, 256> table;
+        for (int v = 0; v < 256; ++v) {
+            table[v] = static_cast<float>(v) / 255.0f;
+        }
+        return table;
+    }();
+    return levels.data();
+}
+
+// Histogram bin of the HSV value of a colour pixel: V scaled to 0-255 and truncated
+static int valueLevel(const float* unit, const unsigned char* px) {
+    return static_cast<int>(unit[std::max(px[0], std::max(px[1], px[2]))] * 255);
+}
+
+// Histogram bin of the HSL lightness of a colour pixel, from its largest and smallest bytes
+static int lightnessLevel(const float* unit, const unsigned char* px) {
+    unsigned char largest = std::max(px[0], std::max(px[1], px[2]));
+    unsigned char smallest = std::min(px[0], std::min(px[1], px[2]));
+    return static_cast<int>((unit[largest] + unit[smallest]) * 0.5f * 255); // halving is exact, like / 2
+}
+
+#if defined(SIMDOPS_SSE2)
+// mask ? a : b, per lane
+static __m128 selectPs(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// The hue of rgbToHsv and rgbToHsl for chromatic pixels, with the red, green, blue priority of
+// their branches turned into masks. Lanes with largest == smallest must be cleared by the caller.
+static __m128 hueOf(__m128 r, __m128 g, __m128 b, __m128 largest, __m128 d) {
+    __m128 isRed = _mm_cmpeq_ps(largest, r);
+    __m128 isGreen = _mm_andnot_ps(isRed, _mm_cmpeq_ps(largest, g));
+    __m128 numerator = selectPs(isRed, _mm_sub_ps(g, b), selectPs(isGreen, _mm_sub_ps(b, r), _mm_sub_ps(r, g)));
+    __m128 offset = selectPs(isRed, _mm_and_ps(_mm_cmplt_ps(g, b), _mm_set1_ps(6)),
+                             selectPs(isGreen, _mm_set1_ps(2), _mm_set1_ps(4)));
+    return _mm_div_ps(_mm_add_ps(_mm_div_ps(numerator, d), offset), _mm_set1_ps(6));
+}
+
+// static_cast<unsigned char>(x * 255.0) per lane, with the product formed in double as hsvToRgb does
+static __m128i scaleToBytesDouble(__m128 x) {
+    const __m128d scale = _mm_set1_pd(255.0);
+    __m128i low = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(x), scale));
+    __m128i high = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), scale));
+    return _mm_unpacklo_epi64(low, high);
+}
+
+// hueToRgb of hslToRgb for four lanes
+static __m128 hueToRgbPs(__m128 p, __m128 q, __m128 t) {
+    const __m128 one = _mm_set1_ps(1);
+    t = selectPs(_mm_cmplt_ps(t, _mm_setzero_ps()), _mm_add_ps(t, one), t);
+    t = selectPs(_mm_cmpgt_ps(t, one), _mm_sub_ps(t, one), t);
+    __m128 span = _mm_sub_ps(q, p);
+    __m128 rising = _mm_add_ps(p, _mm_mul_ps(_mm_mul_ps(span, _mm_set1_ps(6)), t));
+    __m128 falling = _mm_add_ps(p, _mm_mul_ps(_mm_mul_ps(span, _mm_sub_ps(_mm_set1_ps(2.0f / 3), t)), _mm_set1_ps(6)));
+    return selectPs(_mm_cmplt_ps(t, _mm_set1_ps(1.0f / 6)), rising,
+                    selectPs(_mm_cmplt_ps(t, _mm_set1_ps(1.0f / 2)), q,
+                             selectPs(_mm_cmplt_ps(t, _mm_set1_ps(2.0f / 3)), falling, p)));
+}
+#endif
+
+/**
+ * Replaces the V channel of RGB(A) pixels in place, computing H and S once per pixel.
+ *
+ * The SSE2 path converts four pixels at a time with the same float operations as rgbToHsv and
+ * hsvToRgb, selecting the branch results with masks, so its output matches the scalar functions
+ * used for the remaining pixels exactly.
+ *
+ * @tparam channels 3 or 4; the alpha channel is left unchanged.
+ * @param pixels The first pixel.
+ * @param count The number of pixels.
+ * @param newValue newValue(index, level) gives the new V, in [0, 1], of pixel number index, whose
+ *                 V falls in histogram bin level.
+ */
+template <int channels, typename NewValue>
+static void equaliseHsvPixels(unsigned char* pixels, std::size_t count, NewValue&& newValue) {
+    const float* unit = unitLevels();
+    std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1);
+    const __m128 six = _mm_set1_ps(6);
+    alignas(16) float red[4], green[4], blue[4], value[4];
+    alignas(16) int32_t out[3][4];
+    for (; i + 4 <= count; i += 4) {
+        unsigned char* px = pixels + i * channels;
+        for (int j = 0; j < 4; ++j) {
+            const unsigned char* p = px + j * channels;
+            red[j] = unit[p[0]];
+            green[j] = unit[p[1]];
+            blue[j] = unit[p[2]];
+            value[j] = newValue(i + j, valueLevel(unit, p));
+        }
+        __m128 r = _mm_load_ps(red), g = _mm_load_ps(green), b = _mm_load_ps(blue), v = _mm_load_ps(value);
+
+        // rgbToHsv, keeping only H and S
+        __m128 largest = _mm_max_ps(r, _mm_max_ps(g, b));
+        __m128 smallest = _mm_min_ps(r, _mm_min_ps(g, b));
+        __m128 d = _mm_sub_ps(largest, smallest);
+        __m128 s = _mm_andnot_ps(_mm_cmpeq_ps(largest, zero), _mm_div_ps(d, largest));
+        __m128 h = _mm_andnot_ps(_mm_cmpeq_ps(largest, smallest), hueOf(r, g, b, largest, d));
+
+        // hsvToRgb with the equalised V
+        __m128 h6 = _mm_mul_ps(h, six);
+        __m128i sector = _mm_cvttps_epi32(h6);
+        __m128 f = _mm_sub_ps(h6, _mm_cvtepi32_ps(sector));
+        __m128 p = _mm_mul_ps(v, _mm_sub_ps(one, s));
+        __m128 q = _mm_mul_ps(v, _mm_sub_ps(one, _mm_mul_ps(f, s)));
+        __m128 t = _mm_mul_ps(v, _mm_sub_ps(one, _mm_mul_ps(_mm_sub_ps(one, f), s)));
+        sector = _mm_sub_epi32(sector, _mm_and_si128(_mm_cmpgt_epi32(sector, _mm_set1_epi32(5)), _mm_set1_epi32(6)));
+        __m128 in[6];
+        for (int k = 0; k < 6; ++k) {
+            in[k] = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, _mm_set1_epi32(k)));
+        }
+        __m128 rOut = selectPs(_mm_or_ps(in[0], in[5]), v, selectPs(in[1], q, selectPs(in[4], t, p)));
+        __m128 gOut = selectPs(in[0], t, selectPs(_mm_or_ps(in[1], in[2]), v, selectPs(in[3], q, p)));
+        __m128 bOut = selectPs(_mm_or_ps(in[3], in[4]), v, selectPs(in[2], t, selectPs(in[5], q, p)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[0]), scaleToBytesDouble(rOut));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[1]), scaleToBytesDouble(gOut));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[2]), scaleToBytesDouble(bOut));
+        for (int j = 0; j < 4; ++j) {
+            px[j * channels] = static_cast<unsigned char>(out[0][j]);
+            px[j * channels + 1] = static_cast<unsigned char>(out[1][j]);
+            px[j * channels + 2] = static_cast<unsigned char>(out[2][j]);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        unsigned char* px = pixels + i * channels;
+        HSV hsv = rgbToHsv(px[0], px[1], px[2]);
+        hsv.v = newValue(i, valueLevel(unit, px));
+        hsvToRgb(hsv, px[0], px[1], px[2]);
+    }
+}
+
 /**
- * Performs histogram equalization on an image.
+ * Replaces the L channel of RGB(A) pixels in place, computing H and S once per pixel.
+ *
+ * Like equaliseHsvPixels, the SSE2 path repeats the float operations of rgbToHsl and hslToRgb
+ * with masks in place of branches, so it matches the scalar functions exactly.
+ *
+ * @tparam channels 3 or 4; the alpha channel is left unchanged.
+ * @param pixels The first pixel.
+ * @param count The number of pixels.
+ * @param newLightness newLightness(index, level) gives the new L, in [0, 1], of pixel number
+ *                     index, whose L falls in histogram bin level.
+ */
+template <int channels, typename NewLightness>
+static void equaliseHslPixels(unsigned char* pixels, std::size_t count, NewLightness&& newLightness) {
+    const float* unit = unitLevels();
+    std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+    const __m128 one = _mm_set1_ps(1);
+    const __m128 two = _mm_set1_ps(2);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 third = _mm_set1_ps(1.0f / 3);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    alignas(16) float red[4], green[4], blue[4], lightness[4];
+    alignas(16) int32_t out[3][4];
+    for (; i + 4 <= count; i += 4) {
+        unsigned char* px = pixels + i * channels;
+        for (int j = 0; j < 4; ++j) {
+            const unsigned char* p = px + j * channels;
+            red[j] = unit[p[0]];
+            green[j] = unit[p[1]];
+            blue[j] = unit[p[2]];
+            lightness[j] = newLightness(i + j, lightnessLevel(unit, p));
+        }
+        __m128 r = _mm_load_ps(red), g = _mm_load_ps(green), b = _mm_load_ps(blue), l = _mm_load_ps(lightness);
+
+        // rgbToHsl, keeping only H and S
+        __m128 largest = _mm_max_ps(r, _mm_max_ps(g, b));
+        __m128 smallest = _mm_min_ps(r, _mm_min_ps(g, b));
+        __m128 original = _mm_mul_ps(_mm_add_ps(largest, smallest), half);
+        __m128 d = _mm_sub_ps(largest, smallest);
+        __m128 s = _mm_div_ps(d, selectPs(_mm_cmpgt_ps(original, half),
+                                          _mm_sub_ps(_mm_sub_ps(two, largest), smallest), _mm_add_ps(largest, smallest)));
+        __m128 achromatic = _mm_cmpeq_ps(largest, smallest);
+        s = _mm_andnot_ps(achromatic, s);
+        __m128 h = _mm_andnot_ps(achromatic, hueOf(r, g, b, largest, d));
+
+        // hslToRgb with the equalised L
+        __m128 q = selectPs(_mm_cmplt_ps(l, half), _mm_mul_ps(l, _mm_add_ps(one, s)),
+                            _mm_sub_ps(_mm_add_ps(l, s), _mm_mul_ps(l, s)));
+        __m128 p = _mm_sub_ps(_mm_mul_ps(two, l), q);
+        __m128 rOut = hueToRgbPs(p, q, _mm_add_ps(h, third));
+        __m128 gOut = hueToRgbPs(p, q, h);
+        __m128 bOut = hueToRgbPs(p, q, _mm_sub_ps(h, third));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[0]), _mm_cvttps_epi32(_mm_mul_ps(rOut, scale)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[1]), _mm_cvttps_epi32(_mm_mul_ps(gOut, scale)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out[2]), _mm_cvttps_epi32(_mm_mul_ps(bOut, scale)));
+        for (int j = 0; j < 4; ++j) {
+            px[j * channels] = static_cast<unsigned char>(out[0][j]);
+            px[j * channels + 1] = static_cast<unsigned char>(out[1][j]);
+            px[j * channels + 2] = static_cast<unsigned char>(out[2][j]);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        unsigned char* px = pixels + i * channels;
+        HSL hsl = rgbToHsl(px[0], px[1], px[2]);
+        hsl.l = newLightness(i, lightnessLevel(unit, px));
+        hslToRgb(hsl, px[0], px[1], px[2]);
+    }
+}
+
+/**
+ * Replaces the V (HSV) or L (HSL) channel of RGB(A) pixels in place.
+ *
+ * @param pixels The first pixel.
+ * @param count The number of pixels.
+ * @param channels 3 or 4; the alpha channel is left unchanged.
+ * @param colorSpace The color space whose channel is replaced.
+ * @param newLevel newLevel(index, level) gives the new channel value, in [0, 1], of pixel number
+ *                 index, whose current value falls in histogram bin level.
+ */
+template <typename NewLevel>
+static void replaceColourLevel(unsigned char* pixels, std::size_t count, int channels, ColorSpace colorSpace,
+                               NewLevel&& newLevel) {
+    if (colorSpace == ColorSpace::HSV) {
+        if (channels == 3) {
+            equaliseHsvPixels<3>(pixels, count, newLevel);
+        }
+        else {
+            equaliseHsvPixels<4>(pixels, count, newLevel);
+        }
+    }
+    else {
+        if (channels == 3) {
+            equaliseHslPixels<3>(pixels, count, newLevel);
+        }
+        else {
+            equaliseHslPixels<4>(pixels, count, newLevel);
+        }
+    }
+}
+
+// Histogram of the V (HSV) or L (HSL) level of colour pixels, scaled to 0-255 and truncated
+static Histogram colourLevelHistogram(const unsigned char* image, std::size_t pixels, int channels, ColorSpace colorSpace) {
+    const float* unit = unitLevels();
+    return colorSpace == ColorSpace::HSV
+        ? Histogram::ofPixels(image, pixels, channels, [unit](const unsigned char* px) { return valueLevel(unit, px); })
+        : Histogram::ofPixels(image, pixels, channels, [unit](const unsigned char* px) { return lightnessLevel(unit, px); });
+}
+
+// Sets the three colour bytes of every pixel to operation(level), where level is the pixel's
+// V (HSV) or L (HSL) histogram bin; the alpha channel is kept
+static void mapColourLevel(unsigned char* image, std::size_t pixels, int channels, ColorSpace colorSpace,
+                           const PointOperation& operation) {
+    const float* unit = unitLevels();
+    Parallel::parallelForChunks(pixels, equalisationChunkPixels, [&](std::size_t offset, std::size_t count) {
+        unsigned char* px = image + offset * channels;
+        for (std::size_t i = 0; i < count; ++i, px += channels) {
+            int level = colorSpace == ColorSpace::HSV ? valueLevel(unit, px) : lightnessLevel(unit, px);
+            px[0] = px[1] = px[2] = operation(static_cast<unsigned char>(level));
+        }
+    });
+}
+
+/**
+ * Performs histogram equalization on an image in place.
+ *
+ * Colour images are equalised on the V (HSV) or L (HSL) channel. V is the largest of the three
+ * colour bytes and L depends only on the largest and smallest, so the histogram is built from
+ * those bytes without any colour conversion, and each pixel is converted once, in the remap.
  *
  * @param image Pointer to the image data.
  * @param width Width of the image.
  * @param height Height of the image.
  * @param channels Number of color channels in the image.
  * @param colorSpace The color space to be used for equalization (e.g., HSV, HSL).
- * @return Pointer to the histogram-equalized image data.
  */
-
-unsigned char* ColourCorrection::histogramEqualisation(unsigned char* image, int width, int height, int channels, ColorSpace colorSpace) {
+void ColourCorrection::histogramEqualisation(unsigned char* image, int width, int height, int channels, ColorSpace colorSpace) {
     int img_size = width * height * channels;
-    unsigned char* equalised_image = new unsigned char[img_size];
+    int total_pixels = width * height;
 
-    if (channels == 1) { // Grayscale case
+    if (channels == 1 || channels == 2) { // Grayscale case, keeping the alpha channel
         // Compute histogram
-        std::vector<int> histogram(256, 0);
-        for (int i = 0; i < img_size; i++) {
-            histogram[image[i]]++;
-        }
+        Histogram histogram(image, total_pixels, channels);
 
         // Compute cumulative distribution function (CDF)
         std::vector<int> cdf(256, 0);
-        cdf[0] = histogram[0];
+        cdf[0] = static_cast<int>(histogram.count(0, 0));
         for (int i = 1; i < 256; i++) {
-            cdf[i] = cdf[i - 1] + histogram[i];
+            cdf[i] = cdf[i - 1] + static_cast<int>(histogram.count(0, i));
         }
 
-        // Normalize CDF and equalize image
+        // Normalize CDF into a lookup table and equalize image
         float cdf_min = cdf[0];
-        for (int i = 0; i < img_size; i++) {
-            equalised_image[i] = static_cast<unsigned char>((cdf[image[i]] - cdf_min) / (width * height - cdf_min) * 255);
+        unsigned char equalised[256];
+        for (int v = 0; v < 256; v++) {
+            equalised[v] = static_cast<unsigned char>((cdf[v] - cdf_min) / (total_pixels - cdf_min) * 255);
         }
+        PointOperation(equalised).map(image, img_size, channels, true);
     }
     else if (channels == 3 || channels == 4) {  // RGB case
-        // Convert to HSV and equalize the V channel
-        std::vector<float> color_channel(width * height);
-        if (colorSpace == ColorSpace::HSV) {
-            for (int i = 0; i < img_size; i += channels) {
-                HSV hsv = rgbToHsv(image[i], image[i + 1], image[i + 2]);
-                color_channel[i / channels] = hsv.v;
-            }
+        // Histogram of the V or L channel, scaled to 0-255 and truncated
+        Histogram histogram = colourLevelHistogram(image, total_pixels, channels, colorSpace);
 
-            // Histogram equalization on the V channel
-            std::vector<int> v_histogram(256, 0);
-            for (float v : color_channel) {
-                int v_int = static_cast<int>(v * 255);
-                v_histogram[v_int]++;
-            }
+        std::vector<int> cdf(256, 0);
+        cdf[0] = static_cast<int>(histogram.count(0, 0));
+        for (int i = 1; i < 256; i++) {
+            cdf[i] = cdf[i - 1] + static_cast<int>(histogram.count(0, i));
+        }
 
-            std::vector<int> v_cdf(256, 0);
-            v_cdf[0] = v_histogram[0];
-            for (int i = 1; i < 256; i++) {
-                v_cdf[i] = v_cdf[i - 1] + v_histogram[i];
-            }
+        // HSV uses the first CDF entry, HSL the smallest one from the second entry on
+        float cdf_min = colorSpace == ColorSpace::HSV ? cdf[0] : *std::min_element(std::next(cdf.begin()), cdf.end());
+        std::vector<float> equalised(256);
+        for (int i = 0; i < 256; i++) {
+            float equalized_level = static_cast<float>(cdf[i] - cdf_min) / (total_pixels - cdf_min) * 255;
+            equalised[i] = equalized_level / 255.0f; // Normalize back to [0, 1] range
+        }
 
-            float cdf_min = v_cdf[0];
-            int total_pixels = width * height;
-            for (int i = 0; i < total_pixels; i++) {
-                int v_int = static_cast<int>(color_channel[i] * 255);
-                float equalized_v = static_cast<float>(v_cdf[v_int] - cdf_min) / (total_pixels - cdf_min) * 255;
-                color_channel[i] = equalized_v / 255.0f; // Normalize back to [0, 1] range
-            }
+        Parallel::parallelForChunks(total_pixels, equalisationChunkPixels, [&](std::size_t offset, std::size_t count) {
+            replaceColourLevel(image + offset * channels, count, channels, colorSpace,
+                               [&](std::size_t, int level) { return equalised[level]; });
+        });
+    }
+}
 
-            // Convert equalized V channel back to RGB
-            for (int i = 0; i < img_size; i += channels) {
-                HSV hsv = rgbToHsv(image[i], image[i + 1], image[i + 2]);
-                hsv.v = color_channel[i / channels];
-                hsvToRgb(hsv, equalised_image[i], equalised_image[i + 1], equalised_image[i + 2]);
+// Tile pair and weight of one column (or row) for bilinear interpolation between tile mappings
+struct TileBlend {
+    int first, second;  // offsets of the two tiles' mappings, tile index * 256
+    float weight;       // weight of the second tile
+};
 
-                // Copy alpha channel for RGBA images
-                if (channels == 4) {
-                    equalised_image[i + 3] = image[i + 3];
-                }
-            }
+/**
+ * Finds, for every position along one axis, the two tiles whose centres surround it.
+ *
+ * Positions before the first centre or after the last one use that tile alone.
+ *
+ * @param length The image size along the axis.
+ * @param tiles The number of tiles along the axis; tile t covers [t * length / tiles, (t + 1) * length / tiles).
+ * @param stride The distance in tiles between neighbouring tiles along the axis.
+ * @return One TileBlend per position.
+ */
+static std::vector<TileBlend> tileBlends(int length, int tiles, int stride) {
+    std::vector<float> centres(tiles);
+    for (int t = 0; t < tiles; ++t) {
+        centres[t] = (t * length / tiles + (t + 1) * length / tiles - 1) / 2.0f;
+    }
+    std::vector<TileBlend> blends(length);
+    int t = 0;
+    for (int p = 0; p < length; ++p) {
+        while (t + 1 < tiles && centres[t + 1] <= p) {
+            ++t;
+        }
+        if (p <= centres[0]) {
+            blends[p] = { 0, 0, 0.0f };
+        }
+        else if (t + 1 == tiles) {
+            blends[p] = { t * stride * 256, t * stride * 256, 0.0f };
+        }
+        else {
+            blends[p] = { t * stride * 256, (t + 1) * stride * 256, (p - centres[t]) / (centres[t + 1] - centres[t]) };
+        }
+    }
+    return blends;
+}
 
+/**
+ * Maps one row of levels through the bilinear blend of the four surrounding tile mappings.
+ *
+ * @param levels The level (0-255) of each pixel of the row.
+ * @param count The number of pixels.
+ * @param top The mappings of the tile row above the pixels' row, 256 entries per tile.
+ * @param bottom The mappings of the tile row below.
+ * @param down The weight of bottom.
+ * @param across The tile pair and weight of each column.
+ * @param out The mapped value of each pixel, in [0, 255].
+ */
+static void interpolateMappings(const unsigned char* levels, std::size_t count, const float* top, const float* bottom,
+                                float down, const TileBlend* across, float* out) {
+    std::size_t x = 0;
+#if defined(SIMDOPS_SSE2)
+    const __m128 vertical = _mm_set1_ps(down);
+    alignas(16) float topLeft[4], topRight[4], bottomLeft[4], bottomRight[4], weight[4];
+    for (; x + 4 <= count; x += 4) {
+        for (int j = 0; j < 4; ++j) {
+            const TileBlend& blend = across[x + j];
+            int level = levels[x + j];
+            topLeft[j] = top[blend.first + level];
+            topRight[j] = top[blend.second + level];
+            bottomLeft[j] = bottom[blend.first + level];
+            bottomRight[j] = bottom[blend.second + level];
+            weight[j] = blend.weight;
         }
-        else if (colorSpace == ColorSpace::HSL) {
-            for (int i = 0; i < img_size; i += channels) {
-                HSL hsl = rgbToHsl(image[i], image[i + 1], image[i + 2]);
-                color_channel[i / channels] = hsl.l;
-            }
+        __m128 horizontal = _mm_load_ps(weight);
+        __m128 upper = _mm_load_ps(topLeft);
+        upper = _mm_add_ps(upper, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(topRight), upper), horizontal));
+        __m128 lower = _mm_load_ps(bottomLeft);
+        lower = _mm_add_ps(lower, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bottomRight), lower), horizontal));
+        _mm_storeu_ps(out + x, _mm_add_ps(upper, _mm_mul_ps(_mm_sub_ps(lower, upper), vertical)));
+    }
+#endif
+    for (; x < count; ++x) {
+        const TileBlend& blend = across[x];
+        int level = levels[x];
+        float upper = top[blend.first + level] + (top[blend.second + level] - top[blend.first + level]) * blend.weight;
+        float lower = bottom[blend.first + level] + (bottom[blend.second + level] - bottom[blend.first + level]) * blend.weight;
+        out[x] = upper + (lower - upper) * down;
+    }
+}
 
-            // Histogram equalization on the L channel
-            std::vector<int> l_histogram(256, 0);
-            for (float l : color_channel) {
-                int l_int = static_cast<int>(l * 255);
-                l_histogram[l_int]++;
-            }
+/**
+ * Performs contrast-limited adaptive histogram equalization (CLAHE) on an image in place.
+ *
+ * The image is split into tileGrid x tileGrid tiles, and each tile is equalised on its own
+ * histogram of the grey level (or of V or L for colour images). Counts above the clip limit are
+ * cut off and spread evenly over all bins first, which bounds how much the tile's contrast can
+ * be stretched. Every pixel is then mapped with the four tiles whose centres surround it,
+ * blended bilinearly, so no seams appear at tile borders.
+ *
+ * The work is two passes over the image whatever the number of tiles: one fills the tile
+ * histograms, in parallel over rows of tiles, and one remaps the pixels, in parallel over rows.
+ *
+ * @param image Pointer to the image data.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param channels Number of color channels in the image.
+ * @param clipLimit The largest bin count, as a multiple of the mean bin count.
+ * @param tileGrid The number of tiles along each axis.
+ * @param colorSpace The color space whose V or L channel is equalised for colour images.
+ */
+void ColourCorrection::adaptiveEqualisation(unsigned char* image, int width, int height, int channels, int clipLimit, int tileGrid, ColorSpace colorSpace) {
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4) {
+        return;
+    }
+    int tilesX = std::max(1, std::min(tileGrid, width));
+    int tilesY = std::max(1, std::min(tileGrid, height));
+    bool colour = channels >= 3;
+    const float* unit = unitLevels();
 
-            std::vector<int> l_cdf(256, 0);
-            l_cdf[0] = l_histogram[0];
-            for (int i = 1; i < 256; i++) {
-                l_cdf[i] = l_cdf[i - 1] + l_histogram[i];
+    // Histogram level of every pixel of a row
+    auto rowLevels = [&](const unsigned char* row, unsigned char* levels) {
+        for (int x = 0; x < width; x++) {
+            const unsigned char* px = row + x * channels;
+            if (!colour) {
+                levels[x] = px[0];
+            }
+            else if (colorSpace == ColorSpace::HSV) {
+                levels[x] = static_cast<unsigned char>(valueLevel(unit, px));
             }
+            else {
+                levels[x] = static_cast<unsigned char>(lightnessLevel(unit, px));
+            }
+        }
+    };
+
+    std::vector<int> columnTile(width);
+    for (int t = 0; t < tilesX; t++) {
+        for (int x = t * width / tilesX; x < (t + 1) * width / tilesX; x++) {
+            columnTile[x] = t * 256;
+        }
+    }
 
-            float cdf_min = *std::min_element(std::next(l_cdf.begin()), l_cdf.end()); // Find the min in the CDF starting from the second element
-            int total_pixels = width * height;
-            for (int i = 0; i < total_pixels; i++) {
-                int l_int = static_cast<int>(color_channel[i] * 255);
-                float equalized_l = static_cast<float>(l_cdf[l_int] - cdf_min) / (total_pixels - cdf_min) * 255;
-                color_channel[i] = equalized_l / 255.0f; // Normalize back to [0, 1] range
+    // First pass: tile histograms, one row of tiles per task
+    std::vector<uint32_t> histograms(static_cast<std::size_t>(tilesX) * tilesY * 256, 0);
+    Parallel::parallelFor(0, tilesY, [&](int ty) {
+        uint32_t* bins = histograms.data() + static_cast<std::size_t>(ty) * tilesX * 256;
+        std::vector<unsigned char> levels(width);
+        for (int y = ty * height / tilesY; y < (ty + 1) * height / tilesY; y++) {
+            rowLevels(image + static_cast<std::size_t>(y) * width * channels, levels.data());
+            for (int x = 0; x < width; x++) {
+                bins[columnTile[x] + levels[x]]++;
             }
+        }
+    });
+
+    // Clip each histogram, redistribute the excess and turn the CDF into the tile's mapping
+    std::vector<float> mappings(histograms.size());
+    Parallel::parallelFor(0, tilesX * tilesY, [&](int tile) {
+        int tx = tile % tilesX, ty = tile / tilesX;
+        uint32_t* bins = histograms.data() + static_cast<std::size_t>(tile) * 256;
+        uint64_t pixels = static_cast<uint64_t>((tx + 1) * width / tilesX - tx * width / tilesX) *
+                          ((ty + 1) * height / tilesY - ty * height / tilesY);
+        uint64_t limit = std::max<uint64_t>(1, static_cast<uint64_t>(clipLimit) * pixels / 256);
 
+        uint64_t excess = 0;
+        for (int v = 0; v < 256; v++) {
+            if (bins[v] > limit) {
+                excess += bins[v] - limit;
+                bins[v] = static_cast<uint32_t>(limit);
+            }
+        }
+        uint32_t share = static_cast<uint32_t>(excess / 256);
+        uint64_t remainder = excess % 256;
+        for (int v = 0; v < 256; v++) {
+            bins[v] += share;
+        }
+        if (remainder > 0) {
+            int step = static_cast<int>(std::max<uint64_t>(256 / remainder, 1));
+            for (int v = 0; v < 256 && remainder > 0; v += step, remainder--) {
+                bins[v]++;
+            }
+        }
 
-            // Convert equalized L channel back to RGB
-            for (int i = 0; i < img_size; i += channels) {
-                HSL hsl = rgbToHsl(image[i], image[i + 1], image[i + 2]);
-                hsl.l = color_channel[i / channels]; // Use the equalized lightness value
-                hslToRgb(hsl, equalised_image[i], equalised_image[i + 1], equalised_image[i + 2]);
+        float* mapping = mappings.data() + static_cast<std::size_t>(tile) * 256;
+        uint64_t cdf = 0;
+        for (int v = 0; v < 256; v++) {
+            cdf += bins[v];
+            mapping[v] = static_cast<float>(cdf) * 255.0f / static_cast<float>(pixels);
+        }
+    });
 
-                // Copy alpha channel for RGBA images
-                if (channels == 4) {
-                    equalised_image[i + 3] = image[i + 3];
+    // Second pass: blend the mappings of the surrounding tiles for every pixel
+    std::vector<TileBlend> across = tileBlends(width, tilesX, 1);
+    std::vector<TileBlend> downwards = tileBlends(height, tilesY, tilesX);
+    Parallel::parallelForChunks(height, 16, [&](std::size_t offset, std::size_t rows) {
+        std::vector<unsigned char> levels(width);
+        std::vector<float> mapped(width);
+        for (std::size_t y = offset; y < offset + rows; y++) {
+            unsigned char* row = image + y * width * channels;
+            rowLevels(row, levels.data());
+            const TileBlend& blend = downwards[y];
+            interpolateMappings(levels.data(), width, mappings.data() + blend.first, mappings.data() + blend.second,
+                                blend.weight, across.data(), mapped.data());
+            if (colour) {
+                replaceColourLevel(row, width, channels, colorSpace,
+                                   [&](std::size_t x, int) { return mapped[x] / 255.0f; });
+            }
+            else {
+                // The alpha channel of grey + alpha images is left as it is
+                for (int x = 0; x < width; x++) {
+                    row[x * channels] = static_cast<unsigned char>(std::min(255.0f, mapped[x] + 0.5f));
                 }
             }
         }
-    }
-
-    return equalised_image;
+    });
 }
 
 /**
- * Applies thresholding to an image.
+ * Applies thresholding to an image in place.
  *
  * @param image Pointer to the image data.
  * @param width Width of the image.
@@ -396,80 +852,297 @@ unsigned char* ColourCorrection::histogramEqualisation(unsigned char* image, int
  * @param channels Number of color channels in the image.
  * @param threshold The threshold value for binarization.
  * @param colorSpace The color space used for thresholding (e.g., HSV, HSL).
- * @return Pointer to the thresholded image data.
  */
-unsigned char* ColourCorrection::applyThresholding(unsigned char* image, int width, int height, int channels, unsigned char threshold, ColorSpace colorSpace) {
+void ColourCorrection::applyThresholding(unsigned char* image, int width, int height, int channels, unsigned char threshold, ColorSpace colorSpace) {
     int img_size = width * height * channels;
-    unsigned char* thresholded_image = new unsigned char[img_size];
 
-    if (channels == 1) {  // Grayscale case
-        for (int i = 0; i < img_size; i++) {
-            thresholded_image[i] = (image[i] < threshold) ? 0 : 255;
-        }
+    if (channels == 1 || channels == 2) {  // Grayscale case, keeping the alpha channel
+        PointOperation::threshold(threshold).map(image, img_size, channels, true);
     }
     else if (channels == 3 || channels == 4) {  // RGB case
-        for (int i = 0; i < img_size; i += channels) {
-            if (colorSpace == ColorSpace::HSV) {
-                // Convert RGB to HSV
-                HSV hsv = rgbToHsv(image[i], image[i + 1], image[i + 2]);
-                // Threshold the V channel
-                unsigned char v_thresholded = (hsv.v * 255 < threshold) ? 0 : 255;
-                // Set all RGB channels to the thresholded value
-                thresholded_image[i] = thresholded_image[i + 1] = thresholded_image[i + 2] = v_thresholded;
-            }
-            else if (colorSpace == ColorSpace::HSL) {
-                // Convert RGB to HSL
-                HSL hsl = rgbToHsl(image[i], image[i + 1], image[i + 2]);
-                // Threshold the L channel
-                unsigned char l_thresholded = (hsl.l * 255 < threshold) ? 0 : 255;
-                // Set all RGB channels to the thresholded value
-                thresholded_image[i] = thresholded_image[i + 1] = thresholded_image[i + 2] = l_thresholded;
-            }
+        // V or L times 255 is below an integer threshold exactly when its truncated level is, so the
+        // level's table entry sets all RGB channels; the alpha channel is left as it is
+        mapColourLevel(image, static_cast<std::size_t>(width) * height, channels, colorSpace,
+                       PointOperation::threshold(threshold));
+    }
+}
 
-            // Copy the alpha channel for RGBA images
-            if (channels == 4) {
-                thresholded_image[i + 3] = image[i + 3];
+/**
+ * Thresholds an image in place at the Otsu thresholds of its histogram.
+ *
+ * One histogram pass (of the V or L channel for colour images) gives the thresholds, and one
+ * lookup-table pass maps the pixels, so no threshold has to be tuned by hand.
+ *
+ * @param image Pointer to the image data.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param channels Number of color channels in the image.
+ * @param classes The number of classes, 2 for a binary image; clamped to [2, 4].
+ * @param colorSpace The color space used for thresholding (e.g., HSV, HSL).
+ * @return The classes - 1 thresholds chosen, each the first level of the next class.
+ */
+std::vector<int> ColourCorrection::otsuThresholding(unsigned char* image, int width, int height, int channels, int classes, ColorSpace colorSpace) {
+    std::size_t total_pixels = static_cast<std::size_t>(width) * height;
+    classes = std::max(2, std::min(4, classes));
+
+    std::vector<int> chosen;
+    if (channels == 1 || channels == 2) {  // Grayscale case, keeping the alpha channel
+        chosen = Histogram(image, total_pixels, channels).otsuThresholds(classes);
+        PointOperation::levels(chosen).map(image, total_pixels * channels, channels, true);
+    }
+    else if (channels == 3 || channels == 4) {  // RGB case
+        chosen = colourLevelHistogram(image, total_pixels, channels, colorSpace).otsuThresholds(classes);
+        mapColourLevel(image, total_pixels, channels, colorSpace, PointOperation::levels(chosen));
+    }
+    return chosen;
+}
+
+// Rows per work item of the local thresholds
+static const std::size_t localThresholdRows = 16;
+// Largest half window: 4095 x 4095 windows keep value sums below 2^32, the limit of IntegralImage
+static const int maxLocalWindowHalf = 2047;
+
+/**
+ * Thresholds every pixel of a level plane against a threshold computed from its window.
+ *
+ * @param image Pointer to the image data, written in place.
+ * @param levels The level of every pixel (the image itself for one channel).
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param channels Number of color channels in the image; the colour bytes of 3- and 4-channel pixels
+ *                 are all set, the alpha channel is kept.
+ * @param half The window reaches half pixels on each side, clipped to the image.
+ * @param thresholdOf thresholdOf(x0, y0, x1, y1, count) gives the threshold of the window
+ *                    x0 <= x < x1, y0 <= y < y1 of count pixels.
+ */
+template <typename ThresholdOf>
+static void thresholdLocally(unsigned char* image, const unsigned char* levels, int width, int height, int channels,
+                             int half, ThresholdOf&& thresholdOf) {
+    int colourBytes = channels >= 3 ? 3 : 1;
+    Parallel::parallelForChunks(height, localThresholdRows, [&](std::size_t offset, std::size_t count) {
+        for (int y = static_cast<int>(offset); y < static_cast<int>(offset + count); ++y) {
+            int y0 = std::max(0, y - half);
+            int y1 = std::min(height, y + half + 1);
+            const unsigned char* levelRow = levels + static_cast<std::size_t>(y) * width;
+            unsigned char* px = image + static_cast<std::size_t>(y) * width * channels;
+            for (int x = 0; x < width; ++x, px += channels) {
+                int x0 = std::max(0, x - half);
+                int x1 = std::min(width, x + half + 1);
+                unsigned char binary = levelRow[x] < thresholdOf(x0, y0, x1, y1, (x1 - x0) * (y1 - y0)) ? 0 : 255;
+                for (int c = 0; c < colourBytes; ++c) {
+                    px[c] = binary;
+                }
             }
         }
+    });
+}
+
+/**
+ * Thresholds an image in place against the statistics of the window around each pixel.
+ *
+ * The window mean and variance come from summed-area tables of the levels and of their squares,
+ * so every pixel costs a few lookups whatever the window size. Colour images are thresholded on
+ * their V (HSV) or L (HSL) level, as by applyThresholding.
+ *
+ * @param image Pointer to the image data.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param channels Number of color channels in the image.
+ * @param method MeanThresholding, BradleyThresholding or SauvolaThresholding.
+ * @param windowSize The side of the window (0 for one eighth of the smaller image side); even sizes
+ *                   are rounded up to the next odd one.
+ * @param sensitivity The constant C (mean-C), the percentage below the mean (Bradley) or k (Sauvola).
+ * @param colorSpace The color space used for thresholding (e.g., HSV, HSL).
+ */
+void ColourCorrection::localThresholding(unsigned char* image, int width, int height, int channels, ColourCorrectionType method, int windowSize, float sensitivity, ColorSpace colorSpace) {
+    std::size_t total_pixels = static_cast<std::size_t>(width) * height;
+    if (total_pixels == 0 || channels < 1 || channels > 4) {
+        return;
     }
 
-    return thresholded_image;
+    // Levels to threshold: the grey channel, or the V or L level of colour pixels
+    std::vector<unsigned char> plane;
+    const unsigned char* levels = image;
+    if (channels != 1) {
+        plane.resize(total_pixels);
+        const float* unit = unitLevels();
+        Parallel::parallelForChunks(total_pixels, equalisationChunkPixels, [&](std::size_t offset, std::size_t count) {
+            const unsigned char* px = image + offset * channels;
+            for (std::size_t i = offset; i < offset + count; ++i, px += channels) {
+                plane[i] = static_cast<unsigned char>(channels == 2 ? px[0]
+                    : colorSpace == ColorSpace::HSV ? valueLevel(unit, px) : lightnessLevel(unit, px));
+            }
+        });
+        levels = plane.data();
+    }
+
+    if (windowSize <= 0) {
+        windowSize = std::min(width, height) / 8;
+    }
+    int half = std::max(1, std::min(windowSize / 2, maxLocalWindowHalf));
+    IntegralImage sums(levels, width, height, 1);
+
+    if (method == MeanThresholding) {
+        thresholdLocally(image, levels, width, height, channels, half, [&](int x0, int y0, int x1, int y1, int count) {
+            return static_cast<float>(sums.sum(x0, y0, x1, y1, 0)) / count - sensitivity;
+        });
+    }
+    else if (method == BradleyThresholding) {
+        float scale = 1.0f - sensitivity / 100.0f;
+        thresholdLocally(image, levels, width, height, channels, half, [&](int x0, int y0, int x1, int y1, int count) {
+            return static_cast<float>(sums.sum(x0, y0, x1, y1, 0)) / count * scale;
+        });
+    }
+    else {
+        // Sums of squares overflow 32 bits for windows of more than about 66 thousand pixels
+        IntegralImage64 squares(levels, width, height, 1, true);
+        thresholdLocally(image, levels, width, height, channels, half, [&](int x0, int y0, int x1, int y1, int count) {
+            double mean = static_cast<double>(sums.sum(x0, y0, x1, y1, 0)) / count;
+            double variance = static_cast<double>(squares.sum(x0, y0, x1, y1, 0)) / count - mean * mean;
+            double deviation = std::sqrt(std::max(0.0, variance));
+            return mean * (1.0 + sensitivity * (deviation / 128.0 - 1.0));
+        });
+    }
 }
 
+// Pixels (salt and pepper) or bytes (Gaussian and speckle) per work item of the noise; a multiple
+// of 4, so every work item starts on a generator block
+static const std::size_t noiseChunkSize = 16 * 1024;
+// Generator streams of the noise types, so one seed gives independent noise of each type
+static const uint32_t saltPepperStream = 0;
+static const uint32_t gaussianStream = 1;
+
 /**
- * Applies salt and pepper noise to an image.
+ * Marks the noisy pixels of a run of random words.
+ *
+ * @param words One random word per pixel.
+ * @param count The number of pixels.
+ * @param saltBelow Words below it make salt (255).
+ * @param noisyAtMost Words up to it make salt or pepper (0); at least saltBelow.
+ * @param noisy Receives 0xFF for noisy pixels, 0 for the others.
+ * @param salt Receives 0xFF for salt pixels, 0 for the others.
+ */
+static void saltAndPepperMasks(const uint32_t* words, std::size_t count, uint32_t saltBelow, uint32_t noisyAtMost,
+                               unsigned char* noisy, unsigned char* salt) {
+    std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+    // Unsigned comparisons as signed ones with the top bits flipped
+    const __m128i flip = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i saltLimit = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(saltBelow)), flip);
+    const __m128i noisyLimit = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(noisyAtMost)), flip);
+    const __m128i ones = _mm_set1_epi32(-1);
+    for (; i + 16 <= count; i += 16) {
+        __m128i noisyMasks[4], saltMasks[4];
+        for (int q = 0; q < 4; ++q) {
+            __m128i word = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i + 4 * q)), flip);
+            noisyMasks[q] = _mm_xor_si128(_mm_cmpgt_epi32(word, noisyLimit), ones);
+            saltMasks[q] = _mm_cmplt_epi32(word, saltLimit);
+        }
+        // Saturating packs keep 0 and -1, narrowing the 32-bit masks to bytes
+        __m128i noisyBytes = _mm_packs_epi16(_mm_packs_epi32(noisyMasks[0], noisyMasks[1]),
+                                             _mm_packs_epi32(noisyMasks[2], noisyMasks[3]));
+        __m128i saltBytes = _mm_packs_epi16(_mm_packs_epi32(saltMasks[0], saltMasks[1]),
+                                            _mm_packs_epi32(saltMasks[2], saltMasks[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(noisy + i), noisyBytes);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(salt + i), saltBytes);
+    }
+#endif
+    for (; i < count; ++i) {
+        noisy[i] = words[i] <= noisyAtMost ? 0xFF : 0;
+        salt[i] = words[i] < saltBelow ? 0xFF : 0;
+    }
+}
+
+/**
+ * Applies salt and pepper noise to an image in place.
+ *
+ * Pixel i is decided by word i of the seeded generator: words below half the noise probability
+ * (scaled to 2^32) make it white, the rest of the words below the probability black. The noise
+ * therefore depends only on the seed, not on the number of threads.
  *
  * @param image Pointer to the image data.
  * @param width Width of the image.
  * @param height Height of the image.
- * @param channels Number of color channels in the image.
+ * @param channels Number of color channels in the image; the alpha channel of 2- and 4-channel
+ *                 images is kept.
  * @param noisePercentage The percentage of the image pixels to be affected by noise.
- * @return Pointer to the noisy image data.
+ * @param seed The generator seed.
  */
-unsigned char* ColourCorrection::saltAndPepperNoise(unsigned char* image, int width, int height, int channels, float noisePercentage) {
-    int img_size = width * height * channels;
-    unsigned char* noisy_image = new unsigned char[img_size];
-    std::memcpy(noisy_image, image, img_size * sizeof(unsigned char));
-
-    // Initialize random seed
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
-
-    // Apply noise based on the noisePercentage
-    for (int i = 0; i < img_size; i += channels) {
-        float randPercent = (std::rand() % 10000) / 10000.0f;
-        if (randPercent < noisePercentage / 100.0f) {
-            // Set the pixel to black or white randomly
-            unsigned char noise_color = (std::rand() % 2 == 0) ? 0 : 255;
-
-            // Apply the same noise color to all color channels
-            for (int ch = 0; ch < channels; ++ch) {
-                if (channels == 4 && ch == 3) {  // Preserve the alpha channel
-                    continue;
+void ColourCorrection::saltAndPepperNoise(unsigned char* image, int width, int height, int channels, float noisePercentage, uint64_t seed) {
+    std::size_t total_pixels = static_cast<std::size_t>(width) * height;
+    double probability = std::max(0.0, std::min(1.0, noisePercentage / 100.0));
+    uint64_t noisyWords = static_cast<uint64_t>(std::llround(probability * 4294967296.0));
+    if (noisyWords == 0) {
+        return;
+    }
+    uint32_t saltBelow = static_cast<uint32_t>(noisyWords / 2);
+    uint32_t noisyAtMost = static_cast<uint32_t>(noisyWords - 1);
+    int colourBytes = channels == 2 || channels == 4 ? channels - 1 : channels;
+
+    Philox random(seed);
+    Parallel::parallelForChunks(total_pixels, noiseChunkSize, [&](std::size_t offset, std::size_t count) {
+        std::size_t blocks = (count + 3) / 4;
+        std::vector<uint32_t> words(4 * blocks);
+        std::vector<unsigned char> noisy(words.size()), salt(words.size());
+        random.fill(words.data(), offset / 4, blocks, saltPepperStream);
+        saltAndPepperMasks(words.data(), count, saltBelow, noisyAtMost, noisy.data(), salt.data());
+
+        unsigned char* px = image + offset * channels;
+        if (channels == 1) {
+            SimdOps::blendBytes(px, salt.data(), noisy.data(), count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i, px += channels) {
+            if (noisy[i]) {
+                for (int ch = 0; ch < colourBytes; ++ch) {
+                    px[ch] = salt[i];
                 }
-                noisy_image[i + ch] = noise_color;
             }
         }
-    }
+    });
+}
 
-    return noisy_image;
-}
\ No newline at end of file
+/**
+ * Adds Gaussian or speckle noise to an image in place.
+ *
+ * Byte i of the image takes a normal variate from words i and i ^ 1 of the seeded generator by
+ * the Box-Muller transform, so the noise depends only on the seed, not on the number of threads.
+ *
+ * @param image Pointer to the image data.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param channels Number of color channels in the image; the alpha channel of 2- and 4-channel
+ *                 images is kept.
+ * @param deviation The standard deviation, in grey levels for Gaussian noise and as a fraction of
+ *                  each value for speckle noise.
+ * @param speckle Whether the noise is multiplied by the value (speckle) or added to it (Gaussian).
+ * @param seed The generator seed.
+ */
+void ColourCorrection::gaussianNoise(unsigned char* image, int width, int height, int channels, float deviation, bool speckle, uint64_t seed) {
+    std::size_t img_size = static_cast<std::size_t>(width) * height * channels;
+    bool hasAlpha = channels == 2 || channels == 4;
+    const float twoPi = 6.283185307f;
+
+    Philox random(seed);
+    Parallel::parallelForChunks(img_size, noiseChunkSize, [&](std::size_t offset, std::size_t count) {
+        std::size_t blocks = (count + 3) / 4;
+        std::vector<uint32_t> words(4 * blocks);
+        random.fill(words.data(), offset / 4, blocks, gaussianStream);
+
+        for (std::size_t i = 0; i < count; i += 2) {
+            // One Box-Muller pair: the radius from a uniform in (0, 1], the angle from one in [0, 1)
+            float radius = std::sqrt(-2.0f * std::log(Philox::unit(words[i]) + 1.0f / 16777216.0f));
+            float angle = twoPi * Philox::unit(words[i + 1]);
+            float normals[2] = {radius * std::cos(angle), radius * std::sin(angle)};
+            for (std::size_t j = i; j < std::min(i + 2, count); ++j) {
+                std::size_t index = offset + j;
+                if (hasAlpha && index % channels == static_cast<std::size_t>(channels - 1)) {
+                    continue;
+                }
+                float value = image[index];
+                float noisy = value + (speckle ? value * deviation : deviation) * normals[j - i];
+                image[index] = static_cast<unsigned char>(std::max(0.0f, std::min(255.0f, std::round(noisy))));
+            }
+        }
+    });
+}
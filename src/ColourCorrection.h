@@ -5,7 +5,9 @@
  *
  * This header file declares the ColourCorrection class and relevant data structures like HSL and HSV.
  * It provides an interface for applying various color correction techniques such as grayscale conversion,
- * brightness adjustment, histogram equalization, thresholding, and salt and pepper noise addition.
+ * brightness adjustment, histogram equalization (global or contrast-limited adaptive), thresholding
+ * (fixed, automatic Otsu, or local mean-C, Bradley and Sauvola), and salt and pepper, Gaussian and
+ * speckle noise addition from a seeded, reproducible generator.
  * Additionally, it includes utility functions for color space conversions between RGB, HSV, and HSL.
  *
  * Key Structures:
@@ -30,6 +32,8 @@
 
 #include "Filter.h"
 #include "Image.h"
+#include <cstdint>
+#include <vector>
 
 
 struct HSL {
@@ -47,7 +51,8 @@ enum class ColorSpace {
 };
 
 // Enum defining the types of colour correction that can be applied.
-enum ColourCorrectionType { Grayscale, BrightnessAdjust, HistogramEqualization, Thresholding, SaltPepperNoise };
+enum ColourCorrectionType { Grayscale, BrightnessAdjust, HistogramEqualization, Thresholding, SaltPepperNoise, CLAHE, OtsuThresholding,
+                           MeanThresholding, BradleyThresholding, SauvolaThresholding, GaussianNoise, SpeckleNoise };
 
 HSV rgbToHsv(unsigned char r, unsigned char g, unsigned char b);
 void hsvToRgb(HSV hsv, unsigned char& r, unsigned char& g, unsigned char& b);
@@ -57,8 +62,19 @@ void hslToRgb(HSL hsl, unsigned char& r, unsigned char& g, unsigned char& b);
 class ColourCorrection : public Filter {
 public:
     // Constructor that takes a colour correction type and an optional parameter.
-    // The parameter can be used for operations like brightness adjustment or thresholding.
-    ColourCorrection(ColourCorrectionType type, int param = 0, ColorSpace colorSpace = ColorSpace::HSV);
+    // The parameter can be used for operations like brightness adjustment or thresholding; for CLAHE
+    // it is the clip limit as a multiple of the mean bin count (0 for the default of 2), and tileGrid
+    // the number of tiles along each axis. For Otsu thresholding it is the number of classes, 2 to 4
+    // (0 for 2). For noise it is the percentage of noisy pixels (salt and pepper), the standard
+    // deviation in grey levels (Gaussian) or the standard deviation in percent of the value (speckle).
+    ColourCorrection(ColourCorrectionType type, int param = 0, ColorSpace colorSpace = ColorSpace::HSV, int tileGrid = 8);
+
+    // Constructor for the local (adaptive) thresholds, which compare each pixel with a threshold
+    // from the windowSize x windowSize window around it (0 for one eighth of the smaller image side):
+    //   MeanThresholding:    mean - sensitivity (the constant C, in grey levels)
+    //   BradleyThresholding: mean * (1 - sensitivity / 100) (sensitivity is a percentage)
+    //   SauvolaThresholding: mean * (1 + sensitivity * (deviation / 128 - 1)) (sensitivity is k)
+    ColourCorrection(ColourCorrectionType type, int windowSize, float sensitivity, ColorSpace colorSpace = ColorSpace::HSV);
 
     // Virtual destructor to support proper cleanup in derived classes.
     virtual ~ColourCorrection();
@@ -66,16 +82,33 @@ public:
     // Override the apply method from the Filter class to apply the selected colour correction.
     void apply(Image& image) override;
 
+    // Thresholds chosen by the last Otsu thresholding
+    const std::vector<int>& getThresholds() const { return thresholds; }
+
+    // Seed of the noise generator; the same seed always gives the same noise. Unless one is set, a
+    // random seed is drawn the first time the noise or getSeed() needs it.
+    void setSeed(uint64_t seed) { this->seed = seed; seedSet = true; }
+    uint64_t getSeed();
+
 private:
     ColourCorrectionType correctionType; // Stores the selected type of colour correction.
     int parameter;  // Parameter for the correction, e.g., brightness value or threshold.
     ColorSpace colorSpace;
+    int tileGrid;   // Tiles along each axis for CLAHE
+    std::vector<int> thresholds; // Thresholds chosen by Otsu thresholding
+    float sensitivity; // C, Bradley's percentage or Sauvola's k for the local thresholds
+    uint64_t seed;     // Seed of the noise generator, once seedSet is true
+    bool seedSet;
     
     static unsigned char* applyGrayscale(unsigned char* image, int width, int height, int channels);
-    static unsigned char* adjustBrightness(unsigned char* image, int width, int height, int channels, int brightness);
-    static unsigned char* histogramEqualisation(unsigned char* image, int width, int height, int channels, ColorSpace colorSpace);
-    static unsigned char* applyThresholding(unsigned char* image, int width, int height, int channels, unsigned char threshold, ColorSpace colorSpace);
-    static unsigned char* saltAndPepperNoise(unsigned char* image, int width, int height, int channels, float noisePercentage);
+    static void adjustBrightness(unsigned char* image, int width, int height, int channels, int brightness);
+    static void histogramEqualisation(unsigned char* image, int width, int height, int channels, ColorSpace colorSpace);
+    static void adaptiveEqualisation(unsigned char* image, int width, int height, int channels, int clipLimit, int tileGrid, ColorSpace colorSpace);
+    static void applyThresholding(unsigned char* image, int width, int height, int channels, unsigned char threshold, ColorSpace colorSpace);
+    static std::vector<int> otsuThresholding(unsigned char* image, int width, int height, int channels, int classes, ColorSpace colorSpace);
+    static void localThresholding(unsigned char* image, int width, int height, int channels, ColourCorrectionType method, int windowSize, float sensitivity, ColorSpace colorSpace);
+    static void saltAndPepperNoise(unsigned char* image, int width, int height, int channels, float noisePercentage, uint64_t seed);
+    static void gaussianNoise(unsigned char* image, int width, int height, int channels, float deviation, bool speckle, uint64_t seed);
 };
 
 #endif // COLOURCORRECTION_H
\ No newline at end of file
@@ -6,10 +6,20 @@
  */
 #include "ColourCorrectionTest.h"
 #include "ColourCorrection.h"
+#include "Histogram.h"
 #include "Image.h"
+#include "Parallel.h"
+#include "Philox.h"
+#include "PointOperation.h"
+#include "SimdOps.h"
+#include "Volume.h"
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <numeric>
 #include <cmath>
+#include <cstdlib>
+#include <random>
 #include <vector>
 #include <cstring>
 
@@ -31,6 +41,24 @@ void ColourCorrectionTest::run(int testType) {
         case TestSaltAndPepperNoise:
             testSaltAndPepperNoise();
             break;
+        case TestPointOperations:
+            testPointOperations();
+            break;
+        case TestCLAHE:
+            testCLAHE();
+            break;
+        case TestOtsuThresholding:
+            testOtsuThresholding();
+            break;
+        case TestLocalThresholding:
+            testLocalThresholding();
+            break;
+        case TestSeededNoise:
+            testSeededNoise();
+            break;
+        case TestVolumeHistogram:
+            testVolumeHistogram();
+            break;
         default:
             std::cerr << "Unknown test type provided." << std::endl;
             break;
@@ -277,6 +305,7 @@ void ColourCorrectionTest::testSaltAndPepperNoise() {
     float noisePercentage = 5.0f; // Expected noise percentage to add
 
     ColourCorrection noise(SaltPepperNoise, static_cast<int>(noisePercentage));
+    noise.setSeed(2024); // The same noise on every run
     noise.apply(image);
 
     int noisyBWCount = calculateBlackWhitePixelCount(image.getData(), image.getWidth(), image.getHeight(), image.getChannels());
@@ -290,4 +319,479 @@ void ColourCorrectionTest::testSaltAndPepperNoise() {
         std::cerr << "Salt and pepper noise test failed: Actual increase does not match the expected." << std::endl
                   << "Expected increase: " << expectedIncrease << " pixels, Actual increase: " << actualIncrease << " pixels." << std::endl;
     }
+}
+
+// This function tests the lookup-table point operations against a plain per-byte table lookup.
+// SimdOps::lookupBytes is run on random bytes with a random table for lengths around the 16- and
+// 32-byte SIMD block sizes, with and without a kept alpha byte, so both the pshufb path and the
+// scalar tail are compared. A composed PointOperation chain is then applied to a random RGBA
+// image: every colour byte must equal the two tables applied in turn and every alpha byte must be
+// unchanged.
+void ColourCorrectionTest::testPointOperations() {
+    std::mt19937 random(2024);
+    unsigned char table[256];
+    for (int v = 0; v < 256; ++v) {
+        table[v] = static_cast<unsigned char>(random());
+    }
+
+    bool lookupCorrect = true;
+    const std::size_t lengths[] = { 0, 1, 15, 16, 17, 31, 32, 33, 64, 100, 1027 };
+    for (int keepStride : { 0, 2, 4 }) {
+        for (std::size_t length : lengths) {
+            std::vector<unsigned char> data(length);
+            for (unsigned char& byte : data) {
+                byte = static_cast<unsigned char>(random());
+            }
+            std::vector<unsigned char> mapped = data;
+            SimdOps::lookupBytes(mapped.data(), length, table, keepStride);
+            // Only whole pixels have their alpha byte kept
+            std::size_t pixelBytes = keepStride > 0 ? length - length % keepStride : 0;
+            for (std::size_t i = 0; i < length; ++i) {
+                bool kept = i < pixelBytes && static_cast<int>(i % keepStride) == keepStride - 1;
+                if (mapped[i] != (kept ? data[i] : table[data[i]])) {
+                    lookupCorrect = false;
+                }
+            }
+        }
+    }
+
+    // A 37 x 5 RGBA image, so rows do not end on a SIMD block
+    const int width = 37, height = 5, channels = 4;
+    std::size_t size = static_cast<std::size_t>(width) * height * channels;
+    unsigned char* pixels = static_cast<unsigned char*>(std::malloc(size));
+    for (std::size_t i = 0; i < size; ++i) {
+        pixels[i] = static_cast<unsigned char>(random());
+    }
+    std::vector<unsigned char> original(pixels, pixels + size);
+    Image image;
+    image.updateData(pixels, width, height, channels);
+
+    PointOperation first = PointOperation::contrastStretch(20, 235);
+    PointOperation second = PointOperation::invert();
+    first.then(second).apply(image);
+
+    bool imageCorrect = true;
+    for (std::size_t i = 0; i < size; ++i) {
+        unsigned char expected = i % channels == channels - 1 ? original[i] : second(first(original[i]));
+        if (image.getData()[i] != expected) {
+            imageCorrect = false;
+        }
+    }
+
+    if (lookupCorrect && imageCorrect) {
+        std::cout << "Point operations test passed: lookupBytes ("
+                  << (SimdOps::hasShuffleLookup() ? "SSSE3 shuffle" : "scalar")
+                  << " path) and a composed contrast stretch and inversion match a per-byte table lookup, with alpha kept." << std::endl;
+    } else {
+        std::cerr << "Point operations test failed:"
+                  << (lookupCorrect ? "" : " lookupBytes does not match a per-byte table lookup.")
+                  << (imageCorrect ? "" : " the composed operation does not match the tables applied in turn.") << std::endl;
+    }
+}
+
+namespace {
+
+// Calculates the standard deviation of the first channel in each of tiles x tiles tiles and
+// returns their average, a measure of local contrast.
+double averageTileStdDev(const unsigned char* data, int width, int height, int channels, int tiles) {
+    double total = 0.0;
+    for (int ty = 0; ty < tiles; ++ty) {
+        for (int tx = 0; tx < tiles; ++tx) {
+            double sum = 0.0, squares = 0.0;
+            int count = 0;
+            for (int y = ty * height / tiles; y < (ty + 1) * height / tiles; ++y) {
+                for (int x = tx * width / tiles; x < (tx + 1) * width / tiles; ++x) {
+                    double value = data[(y * width + x) * channels];
+                    sum += value;
+                    squares += value * value;
+                    ++count;
+                }
+            }
+            double mean = sum / count;
+            total += std::sqrt(std::max(0.0, squares / count - mean * mean));
+        }
+    }
+    return total / (tiles * tiles);
+}
+
+} // namespace
+
+// This function tests contrast-limited adaptive histogram equalization (CLAHE) on synthetic images:
+//   - a uniform grey image must stay uniform, since every tile has the same histogram;
+//   - a faint checkerboard under a strong left-to-right illumination gradient must come out with
+//     more local contrast, measured as the average standard deviation over the 8 x 8 tiles;
+//   - on an RGBA version of the same image every alpha byte must be left unchanged.
+void ColourCorrectionTest::testCLAHE() {
+    const int width = 128, height = 128;
+
+    unsigned char* uniformData = static_cast<unsigned char*>(std::malloc(width * height));
+    std::memset(uniformData, 90, width * height);
+    Image uniform;
+    uniform.updateData(uniformData, width, height, 1);
+    ColourCorrection(CLAHE).apply(uniform);
+    bool uniformKept = true;
+    for (int i = 1; i < width * height; ++i) {
+        uniformKept = uniformKept && uniform.getData()[i] == uniform.getData()[0];
+    }
+
+    // Illumination from 40 to 200 across the image, with a checkerboard of +-6 in 4 x 4 cells
+    auto unevenLevel = [&](int x, int y) {
+        int light = 40 + 160 * x / (width - 1);
+        return static_cast<unsigned char>(light + (((x / 4) + (y / 4)) % 2 == 0 ? 6 : -6));
+    };
+    unsigned char* greyData = static_cast<unsigned char*>(std::malloc(width * height));
+    unsigned char* rgbaData = static_cast<unsigned char*>(std::malloc(width * height * 4));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char level = unevenLevel(x, y);
+            greyData[y * width + x] = level;
+            unsigned char* px = rgbaData + (y * width + x) * 4;
+            px[0] = level;
+            px[1] = static_cast<unsigned char>(level / 2);
+            px[2] = static_cast<unsigned char>(255 - level);
+            px[3] = static_cast<unsigned char>((x * 7 + y * 13) % 256);
+        }
+    }
+    std::vector<unsigned char> originalRgba(rgbaData, rgbaData + width * height * 4);
+
+    Image grey;
+    grey.updateData(greyData, width, height, 1);
+    double originalContrast = averageTileStdDev(grey.getData(), width, height, 1, 8);
+    ColourCorrection(CLAHE).apply(grey);
+    double equalisedContrast = averageTileStdDev(grey.getData(), width, height, 1, 8);
+
+    Image rgba;
+    rgba.updateData(rgbaData, width, height, 4);
+    ColourCorrection(CLAHE, 0, ColorSpace::HSL).apply(rgba);
+    bool alphaKept = rgba.getChannels() == 4;
+    bool colourChanged = false;
+    for (int i = 0; i < width * height * 4 && alphaKept; ++i) {
+        if (i % 4 == 3) {
+            alphaKept = rgba.getData()[i] == originalRgba[i];
+        } else if (rgba.getData()[i] != originalRgba[i]) {
+            colourChanged = true;
+        }
+    }
+
+    if (uniformKept && equalisedContrast > originalContrast && alphaKept && colourChanged) {
+        std::cout << "CLAHE test passed: A uniform image stays uniform, the average tile standard deviation of an unevenly lit image rose from "
+                  << originalContrast << " to " << equalisedContrast << ", and the alpha channel of an RGBA image is kept." << std::endl;
+    } else {
+        std::cerr << "CLAHE test failed:"
+                  << (uniformKept ? "" : " a uniform image did not stay uniform.")
+                  << (equalisedContrast > originalContrast ? "" : " local contrast did not increase.")
+                  << (alphaKept ? "" : " the alpha channel changed.")
+                  << (colourChanged ? "" : " the colour channels of the RGBA image were not equalised.") << std::endl;
+    }
+}
+
+namespace {
+
+// Calculates the between-class variance of a histogram split into classes at the given thresholds
+// (each threshold is the first value of the next class), straight from the bins.
+double betweenClassVariance(const Histogram& histogram, const std::vector<int>& thresholds) {
+    double total = static_cast<double>(histogram.total());
+    double mean = histogram.mean();
+    double variance = 0.0;
+    int begin = 0;
+    for (std::size_t k = 0; k <= thresholds.size(); ++k) {
+        int end = k < thresholds.size() ? thresholds[k] : 256;
+        double pixels = 0.0, sum = 0.0;
+        for (int v = begin; v < end; ++v) {
+            pixels += histogram.count(0, v);
+            sum += static_cast<double>(histogram.count(0, v)) * v;
+        }
+        if (pixels > 0.0) {
+            double classMean = sum / pixels;
+            variance += pixels / total * (classMean - mean) * (classMean - mean);
+        }
+        begin = end;
+    }
+    return variance;
+}
+
+} // namespace
+
+// This function tests Otsu thresholding on a synthetic trimodal grey image (three normal
+// distributions around 40, 120 and 210). The two- and three-class thresholds from
+// Histogram::otsuThresholds must reach the largest between-class variance found by trying every
+// threshold and every pair of thresholds; the variance is compared rather than the thresholds, as
+// empty bins between the modes give equally good ones. Applying the three-class
+// OtsuThresholding correction must then map each class to 0, 128 and 255.
+void ColourCorrectionTest::testOtsuThresholding() {
+    const int width = 160, height = 120;
+    std::mt19937 random(2024);
+    std::normal_distribution<double> modes[3] = { std::normal_distribution<double>(40.0, 10.0),
+                                                  std::normal_distribution<double>(120.0, 15.0),
+                                                  std::normal_distribution<double>(210.0, 12.0) };
+    unsigned char* pixels = static_cast<unsigned char*>(std::malloc(width * height));
+    for (int i = 0; i < width * height; ++i) {
+        double value = modes[random() % 3](random);
+        pixels[i] = static_cast<unsigned char>(std::max(0.0, std::min(255.0, std::round(value))));
+    }
+    std::vector<unsigned char> original(pixels, pixels + width * height);
+    Histogram histogram(pixels, width * height, 1);
+
+    double bestTwo = 0.0, bestThree = 0.0;
+    for (int t1 = 1; t1 < 256; ++t1) {
+        bestTwo = std::max(bestTwo, betweenClassVariance(histogram, { t1 }));
+        for (int t2 = t1 + 1; t2 < 256; ++t2) {
+            bestThree = std::max(bestThree, betweenClassVariance(histogram, { t1, t2 }));
+        }
+    }
+    std::vector<int> two = histogram.otsuThresholds(2);
+    std::vector<int> three = histogram.otsuThresholds(3);
+    bool twoOptimal = std::fabs(betweenClassVariance(histogram, two) - bestTwo) <= 1e-9 * bestTwo;
+    bool threeOptimal = three.size() == 2 && three[0] < three[1] &&
+                        std::fabs(betweenClassVariance(histogram, three) - bestThree) <= 1e-9 * bestThree;
+
+    Image image;
+    image.updateData(pixels, width, height, 1);
+    ColourCorrection otsu(OtsuThresholding, 3);
+    otsu.apply(image);
+    const std::vector<int>& applied = otsu.getThresholds();
+    bool classesCorrect = applied == three;
+    for (int i = 0; i < width * height && classesCorrect; ++i) {
+        unsigned char expected = original[i] < applied[0] ? 0 : (original[i] < applied[1] ? 128 : 255);
+        classesCorrect = image.getData()[i] == expected;
+    }
+
+    if (twoOptimal && threeOptimal && classesCorrect) {
+        std::cout << "Otsu thresholding test passed: The thresholds of a trimodal image (" << two[0] << " for two classes, "
+                  << three[0] << " and " << three[1] << " for three) reach the best between-class variance of an exhaustive search, "
+                  << "and the pixels are mapped to 0, 128 and 255 by class." << std::endl;
+    } else {
+        std::cerr << "Otsu thresholding test failed:"
+                  << (twoOptimal ? "" : " the two-class threshold is not optimal.")
+                  << (threeOptimal ? "" : " the three-class thresholds are not optimal.")
+                  << (classesCorrect ? "" : " the thresholded image does not match the classes.") << std::endl;
+    }
+}
+
+// This function tests the local thresholds against a naive reference on a small random grey image.
+// For every pixel the reference takes the mean and standard deviation of the windowSize x
+// windowSize window around it (cut off at the image borders) with a plain loop, computes the
+// mean-C, Bradley or Sauvola threshold, and sets the pixel to 0 below it and 255 otherwise. The
+// corrections must agree on every pixel except those within a rounding error of their threshold.
+void ColourCorrectionTest::testLocalThresholding() {
+    const int width = 23, height = 17, windowSize = 7, half = windowSize / 2;
+    std::mt19937 random(2024);
+    std::vector<unsigned char> original(width * height);
+    for (int i = 0; i < width * height; ++i) {
+        // A gradient plus noise, so that no single global threshold separates the pixels
+        original[i] = static_cast<unsigned char>(std::min(255, static_cast<int>(4 * (i % width) + random() % 160)));
+    }
+
+    struct Case { ColourCorrectionType type; float sensitivity; const char* name; };
+    const Case cases[] = { { MeanThresholding, 5.0f, "Mean-C" }, { BradleyThresholding, 15.0f, "Bradley" },
+                           { SauvolaThresholding, 0.2f, "Sauvola" } };
+    bool allCorrect = true;
+    for (const Case& test : cases) {
+        unsigned char* pixels = static_cast<unsigned char*>(std::malloc(width * height));
+        std::memcpy(pixels, original.data(), width * height);
+        Image image;
+        image.updateData(pixels, width, height, 1);
+        ColourCorrection(test.type, windowSize, test.sensitivity).apply(image);
+
+        int mismatches = 0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                double sum = 0.0, squares = 0.0;
+                int count = 0;
+                for (int wy = std::max(0, y - half); wy <= std::min(height - 1, y + half); ++wy) {
+                    for (int wx = std::max(0, x - half); wx <= std::min(width - 1, x + half); ++wx) {
+                        double value = original[wy * width + wx];
+                        sum += value;
+                        squares += value * value;
+                        ++count;
+                    }
+                }
+                double mean = sum / count;
+                double deviation = std::sqrt(std::max(0.0, squares / count - mean * mean));
+                double threshold = test.type == MeanThresholding ? mean - test.sensitivity
+                                 : test.type == BradleyThresholding ? mean * (1.0 - test.sensitivity / 100.0)
+                                 : mean * (1.0 + test.sensitivity * (deviation / 128.0 - 1.0));
+                unsigned char level = original[y * width + x];
+                if (std::fabs(level - threshold) < 1e-3) {
+                    continue;
+                }
+                if (image.getData()[y * width + x] != (level < threshold ? 0 : 255)) {
+                    ++mismatches;
+                }
+            }
+        }
+        if (mismatches != 0) {
+            std::cerr << test.name << " thresholding differs from the naive reference at " << mismatches << " pixels." << std::endl;
+            allCorrect = false;
+        }
+    }
+
+    if (allCorrect) {
+        std::cout << "Local thresholding test passed: Mean-C, Bradley and Sauvola thresholding of a random 23x17 image with a 7x7 window "
+                  << "match a naive window mean and deviation at every pixel." << std::endl;
+    } else {
+        std::cerr << "Local thresholding test failed: The thresholded image does not match the naive reference." << std::endl;
+    }
+}
+
+namespace {
+
+// Creates a width x height image of the given channels filled by value(index), for noise tests.
+template <typename ValueOf>
+void fillTestImage(Image& image, int width, int height, int channels, ValueOf&& value) {
+    std::size_t size = static_cast<std::size_t>(width) * height * channels;
+    unsigned char* data = static_cast<unsigned char*>(std::malloc(size));
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = value(i);
+    }
+    image.updateData(data, width, height, channels);
+}
+
+// Calculates the mean and standard deviation of the first channel of an image.
+void channelStatistics(const Image& image, double& mean, double& deviation) {
+    std::size_t pixels = static_cast<std::size_t>(image.getWidth()) * image.getHeight();
+    double sum = 0.0, squares = 0.0;
+    for (std::size_t i = 0; i < pixels; ++i) {
+        double value = image.getData()[i * image.getChannels()];
+        sum += value;
+        squares += value * value;
+    }
+    mean = sum / pixels;
+    deviation = std::sqrt(std::max(0.0, squares / pixels - mean * mean));
+}
+
+} // namespace
+
+// This function tests the seeded noise generators:
+//   - Philox(0).block(0) must give the published Philox4x32-10 known answer for a zero key and
+//     counter, and fill() (the SIMD path) must give the same words as block() one at a time;
+//   - salt and pepper, Gaussian and speckle noise with the same seed must give byte-identical
+//     images with 1 and 7 worker threads, keep the alpha channel of an RGBA image, and change
+//     with the seed;
+//   - Gaussian noise of deviation 20 on a flat grey image and speckle noise of 20% on a flat
+//     image of 100 must leave the mean in place and give a standard deviation close to 20.
+void ColourCorrectionTest::testSeededNoise() {
+    const std::array<uint32_t, 4> knownAnswer = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+    bool knownAnswerCorrect = Philox(0).block(0) == knownAnswer;
+
+    Philox random(2024);
+    const std::size_t blocks = 29;
+    std::vector<uint32_t> words(4 * blocks);
+    random.fill(words.data(), 5, blocks, 1);
+    bool fillCorrect = true;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        std::array<uint32_t, 4> expected = random.block(5 + b, 1);
+        fillCorrect = fillCorrect && std::equal(expected.begin(), expected.end(), words.begin() + 4 * b);
+    }
+
+    // An RGBA image of 240000 bytes, so the noise is split over several chunks and threads
+    const int width = 300, height = 200, channels = 4;
+    auto pattern = [](std::size_t i) { return static_cast<unsigned char>((i * 37 + i / 1200) % 256); };
+    const ColourCorrectionType types[] = { SaltPepperNoise, GaussianNoise, SpeckleNoise };
+    const char* names[] = { "Salt and pepper", "Gaussian", "Speckle" };
+    bool reproducible = true;
+    int previousThreads = Parallel::getThreadCount();
+    for (int t = 0; t < 3; ++t) {
+        Image single, multi, reseeded;
+        fillTestImage(single, width, height, channels, pattern);
+        fillTestImage(multi, width, height, channels, pattern);
+        fillTestImage(reseeded, width, height, channels, pattern);
+        ColourCorrection noise(types[t], 20);
+        noise.setSeed(2024);
+        Parallel::setThreadCount(1);
+        noise.apply(single);
+        Parallel::setThreadCount(7);
+        noise.apply(multi);
+        noise.setSeed(2025);
+        noise.apply(reseeded);
+
+        std::size_t size = static_cast<std::size_t>(width) * height * channels;
+        bool identical = std::memcmp(single.getData(), multi.getData(), size) == 0;
+        bool seedMatters = std::memcmp(single.getData(), reseeded.getData(), size) != 0;
+        bool alphaKept = true;
+        for (std::size_t i = channels - 1; i < size; i += channels) {
+            alphaKept = alphaKept && single.getData()[i] == pattern(i);
+        }
+        if (!identical || !seedMatters || !alphaKept) {
+            std::cerr << names[t] << " noise:"
+                      << (identical ? "" : " differs between 1 and 7 threads.")
+                      << (seedMatters ? "" : " does not change with the seed.")
+                      << (alphaKept ? "" : " changes the alpha channel.") << std::endl;
+            reproducible = false;
+        }
+    }
+    Parallel::setThreadCount(previousThreads);
+
+    double gaussianMean, gaussianDeviation, speckleMean, speckleDeviation;
+    Image flat;
+    fillTestImage(flat, 256, 256, 1, [](std::size_t) { return static_cast<unsigned char>(128); });
+    ColourCorrection gaussian(GaussianNoise, 20);
+    gaussian.setSeed(2024);
+    gaussian.apply(flat);
+    channelStatistics(flat, gaussianMean, gaussianDeviation);
+    fillTestImage(flat, 256, 256, 1, [](std::size_t) { return static_cast<unsigned char>(100); });
+    ColourCorrection speckle(SpeckleNoise, 20);
+    speckle.setSeed(2024);
+    speckle.apply(flat);
+    channelStatistics(flat, speckleMean, speckleDeviation);
+    bool statisticsCorrect = std::fabs(gaussianMean - 128.0) < 0.5 && std::fabs(gaussianDeviation - 20.0) < 0.5 &&
+                             std::fabs(speckleMean - 100.0) < 0.5 && std::fabs(speckleDeviation - 20.0) < 0.5;
+
+    if (knownAnswerCorrect && fillCorrect && reproducible && statisticsCorrect) {
+        std::cout << "Seeded noise test passed: Philox matches its known answer, salt and pepper, Gaussian and speckle noise "
+                  << "are identical with 1 and 7 threads for the same seed, and the Gaussian and speckle deviations are "
+                  << gaussianDeviation << " and " << speckleDeviation << " (expected 20)." << std::endl;
+    } else {
+        std::cerr << "Seeded noise test failed:"
+                  << (knownAnswerCorrect ? "" : " Philox(0).block(0) does not match the known answer.")
+                  << (fillCorrect ? "" : " Philox::fill does not match Philox::block.")
+                  << (reproducible ? "" : " the noise is not reproducible.")
+                  << (statisticsCorrect ? "" : " the noise statistics are off.") << std::endl;
+    }
+}
+
+// Tests the volume histogram, which the 3D statistics share with the 2D colour corrections.
+// An empty volume (no voxels and no channels, as after default construction or loading a
+// directory without slices) must give an empty histogram rather than crash. A random two-channel
+// volume of 360,000 pixels, enough for up to six workers of Histogram::minimumPixelsPerThread
+// pixels each, must give the same counts as a naive loop over its voxels with one thread and
+// with several threads whose per-thread bins are merged.
+void ColourCorrectionTest::testVolumeHistogram() {
+    Volume empty;
+    Histogram emptyHistogram(empty);
+    bool emptyCorrect = emptyHistogram.getChannels() == 0 && emptyHistogram.merged().total() == 0 &&
+                        emptyHistogram.merged().standardDeviation() == 0.0;
+
+    const int width = 120, height = 100, depth = 30, channels = 2;
+    Volume volume(width, height, depth, channels);
+    std::mt19937 random(2024);
+    for (std::size_t i = 0; i < volume.getVoxelCount(); ++i) {
+        volume.getData()[i] = static_cast<unsigned char>(random());
+    }
+    std::vector<uint64_t> expected(channels * 256, 0);
+    for (std::size_t i = 0; i < volume.getVoxelCount(); ++i) {
+        expected[(i % channels) * 256 + volume.getData()[i]]++;
+    }
+
+    bool countsCorrect = true;
+    for (int threads : { 1, 3, 8 }) {
+        Histogram histogram(volume, threads);
+        countsCorrect = countsCorrect && histogram.getChannels() == channels;
+        for (int ch = 0; ch < channels && countsCorrect; ++ch) {
+            for (int v = 0; v < 256; ++v) {
+                if (histogram.count(ch, v) != expected[ch * 256 + v]) {
+                    countsCorrect = false;
+                }
+            }
+        }
+    }
+
+    if (emptyCorrect && countsCorrect) {
+        std::cout << "Volume Histogram Test Passed: An empty volume gives an empty histogram, and a 120x100x30 "
+                  << "two-channel volume matches a naive count with 1, 3 and 8 threads." << std::endl;
+    } else {
+        std::cerr << "Volume Histogram Test Failed:"
+                  << (emptyCorrect ? "" : " an empty volume does not give an empty histogram.")
+                  << (countsCorrect ? "" : " the counts do not match a naive count.") << std::endl;
+    }
 }
\ No newline at end of file
@@ -15,7 +15,13 @@ enum ColourCorrectionTestType {
     TestBrightnessAdjustment, // Test for brightness adjustment.
     TestHistogramEqualization, // Test for histogram equalization.
     TestThresholding, // Test for thresholding.
-    TestSaltAndPepperNoise // Test for adding salt and pepper noise.
+    TestSaltAndPepperNoise, // Test for adding salt and pepper noise.
+    TestPointOperations, // Test for lookup-table point operations.
+    TestCLAHE, // Test for contrast-limited adaptive histogram equalization.
+    TestOtsuThresholding, // Test for automatic Otsu thresholding.
+    TestLocalThresholding, // Test for mean-C, Bradley and Sauvola local thresholding.
+    TestSeededNoise, // Test for reproducible Gaussian, speckle and salt and pepper noise.
+    TestVolumeHistogram // Test for histograms of whole volumes.
 };
 
 class ColourCorrectionTest : public Test {
@@ -28,6 +34,12 @@ private:
     void testHistogramEqualization(); // Tests histogram equalization.
     void testThresholding(); // Tests thresholding.
     void testSaltAndPepperNoise(); // Tests adding salt and pepper noise.
+    void testPointOperations(); // Tests lookup-table point operations.
+    void testCLAHE(); // Tests contrast-limited adaptive histogram equalization.
+    void testOtsuThresholding(); // Tests automatic Otsu thresholding.
+    void testLocalThresholding(); // Tests mean-C, Bradley and Sauvola local thresholding.
+    void testSeededNoise(); // Tests reproducible Gaussian, speckle and salt and pepper noise.
+    void testVolumeHistogram(); // Tests histograms of whole volumes.
 };
 
 #endif // COLOURCORRECTIONTEST_H
\ No newline at end of file
@@ -8,10 +8,14 @@
  * The class is designed to preprocess images using grayscale conversion and Gaussian blur
  * (except in certain cases like Roberts Cross), followed by the application of the chosen
  * edge detection operator. Each operator is implemented as a separate method, and a common
- * method is used to apply the edge detection logic.
+ * method is used to apply the edge detection logic. The three steps are fused: rows are
+ * converted, smoothed and differentiated as they stream through a few row buffers, so no
+ * full-size intermediate image is made. The operators' kernels are compile-time constants
+ * (GradientKernels), and gradients and magnitudes are computed eight pixels at a time.
  *
  * Key Features:
  *   - Supports various edge detection techniques.
+ *   - Canny edge detection with tiled, parallel non-maximum suppression and hysteresis.
  *   - Preprocesses images for optimal edge detection.
  *   - Provides flexibility to extend and add more edge detection methods.
  *
@@ -19,28 +23,49 @@
  *   EdgeDetection edgeDetector(EdgeDetection::Sobel);
  *   edgeDetector.apply(image); // 'image' is an instance of Image class
  *
- * @note This class relies on other image processing classes like ColourCorrection and ImageBlur
- *       and expects them to be defined and included in the project.
+ * @note This class relies on ImageBlur's Gaussian weights and on GaussianRowFilter, and
+ *       expects them to be defined and included in the project.
  * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
  *         edsml-hs1623, acse-xg1123, edsml-st2923,
  *         Group: selection sort.
  */
 
 #include "EdgeDetection.h"
+#include "GaussianRowFilter.h"
 #include "ImageBlur.h"
-#include "ColourCorrection.h"
+#include "Parallel.h"
+#include "SimdOps.h"
 #include <vector>
 #include <algorithm> // for std::min and std::max
 #include <filesystem>
 #include <cmath>
+#include <cstdlib>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 
 /**
 * Constructor: Constructor for EdgeDetection class.
 *
 * @param operatorType The type of edge operator to use (e.g., Sobel, Prewitt).
+* @param output What to output per pixel: the gradient magnitude (default, exact L2) or an
+*               approximation of it, or the gradient direction.
+*/
+EdgeDetection::EdgeDetection(EdgeOperator operatorType, GradientOutput output)
+    : operatorType(operatorType), output(output), lowThreshold(40), highThreshold(100) {}
+
+/**
+* Constructor: Constructor for EdgeDetection class with Canny thresholds.
+*
+* @param operatorType The type of edge operator to use; the thresholds only affect Canny.
+* @param lowThreshold Gradient magnitude above which a pixel is a weak edge, kept only if it is
+*                     connected to a strong edge.
+* @param highThreshold Gradient magnitude above which a pixel is a strong edge.
 */
-EdgeDetection::EdgeDetection(EdgeOperator operatorType) : operatorType(operatorType) {}
+EdgeDetection::EdgeDetection(EdgeOperator operatorType, int lowThreshold, int highThreshold)
+    : operatorType(operatorType), output(MagnitudeL2), lowThreshold(lowThreshold), highThreshold(highThreshold) {}
 
 /**
  * Destructor: Destructor for EdgeDetection class.
@@ -66,6 +91,9 @@ void EdgeDetection::apply(Image& image) {
     case RobertsCross:
         applyRobertsCross(image);
         break;
+    case Canny:
+        applyCanny(image);
+        break;
     default:
         std::cerr << "Unknown edge operator." << std::endl;
         break;
@@ -79,26 +107,8 @@ void EdgeDetection::apply(Image& image) {
  * @param image The image to apply Sobel operator on.
  */
 void EdgeDetection::applySobel(Image& image) {
-    int width = image.getWidth();
-    int height = image.getHeight();
-    int channels = image.getChannels();
-    unsigned char* data = image.getData();
-    std::vector<unsigned char> newData(width * height * channels);
-
-    // Apply grayscale as preprocessing step
-    ColourCorrection grayscale(Grayscale);
-    grayscale.apply(image);
-
-    // Apply Gaussian blur as preprocessing step
-    ImageBlur blur(Gaussian, 5); // Adjust kernel size as needed
-    blur.apply(image);
-
-    // Sobel operator kernels
-    const std::vector<std::vector<int>> sobelKernelX = { {-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1} };
-    const std::vector<std::vector<int>> sobelKernelY = { {-1, -2, -1}, {0, 0, 0}, {1, 2, 1} };
-
-    // Apply Sobel operator
-    applyEdgeDetection(image, sobelKernelX, sobelKernelY);
+    // Apply grayscale, Gaussian blur and the Sobel operator in one pass
+    detectEdges<Sobel>(image);
 }
 
 /**
@@ -108,26 +118,8 @@ void EdgeDetection::applySobel(Image& image) {
  * @param image The image to apply Prewitt operator on.
  */
 void EdgeDetection::applyPrewitt(Image& image) {
-    int width = image.getWidth();
-    int height = image.getHeight();
-    int channels = image.getChannels();
-    unsigned char* data = image.getData();
-    std::vector<unsigned char> newData(width * height * channels);
-
-    // Apply grayscale as preprocessing step
-    ColourCorrection grayscale(Grayscale);
-    grayscale.apply(image);
-
-    // Apply Gaussian blur as preprocessing step
-    ImageBlur blur(Gaussian, 5); // Adjust kernel size as needed
-    blur.apply(image);
-
-    // Prewitt operator kernels
-    const std::vector<std::vector<int>> prewittKernelX = { {-1, 0, 1}, {-1, 0, 1}, {-1, 0, 1} };
-    const std::vector<std::vector<int>> prewittKernelY = { {-1, -1, -1}, {0, 0, 0}, {1, 1, 1} };
-
-    // Apply Prewitt operator
-    applyEdgeDetection(image, prewittKernelX, prewittKernelY);
+    // Apply grayscale, Gaussian blur and the Prewitt operator in one pass
+    detectEdges<Prewitt>(image);
 }
 
 /**
@@ -137,112 +129,428 @@ void EdgeDetection::applyPrewitt(Image& image) {
  * @param image The image to apply Scharr operator on.
  */
 void EdgeDetection::applyScharr(Image& image) {
-    int width = image.getWidth();
-    int height = image.getHeight();
-    int channels = image.getChannels();
-    unsigned char* data = image.getData();
-    std::vector<unsigned char> newData(width * height * channels);
-
-    // Apply grayscale as preprocessing step
-    ColourCorrection grayscale(Grayscale);
-    grayscale.apply(image);
-
-    // Apply Gaussian blur as preprocessing step
-    ImageBlur blur(Gaussian, 5); // Adjust kernel size as needed
-    blur.apply(image);
-
-    // Scharr operator kernels
-    const std::vector<std::vector<int>> scharrKernelX = { {-3, 0, 3}, {-10, 0, 10}, {-3, 0, 3} };
-    const std::vector<std::vector<int>> scharrKernelY = { {-3, -10, -3}, {0, 0, 0}, {3, 10, 3} };
-
-    // Apply Scharr operator
-    applyEdgeDetection(image, scharrKernelX, scharrKernelY);
+    // Apply grayscale, Gaussian blur and the Scharr operator in one pass
+    detectEdges<Scharr>(image);
 }
 
 /**
  * Applies the Roberts Cross edge detection operator to an image.
  * This involves grayscale conversion and Roberts Cross convolution.
- * Note: Gaussian blur is not applied for Roberts Cross.
+ * Note: Gaussian blur is not applied for Roberts Cross (see GradientKernels<RobertsCross>).
  *
  * @param image The image to apply Roberts Cross operator on.
  */
 void EdgeDetection::applyRobertsCross(Image& image) {
+    // Apply grayscale and the Roberts Cross operator in one pass
+    detectEdges<RobertsCross>(image);
+}
+
+/**
+ * Converts one row of pixels to luma with the same weights as ColourCorrection's grayscale
+ * conversion. Images with fewer than three channels are already gray, so channel 0 is used.
+ *
+ * @param row The source row.
+ * @param width The number of pixels in the row.
+ * @param channels The number of interleaved channels.
+ * @param gray The destination row, width bytes.
+ */
+static void lumaRow(const unsigned char* row, int width, int channels, unsigned char* gray) {
+    if (channels < 3) {
+        for (int x = 0; x < width; ++x) {
+            gray[x] = row[x * channels];
+        }
+        return;
+    }
+    for (int x = 0; x < width; ++x) {
+        const unsigned char* pixel = row + x * channels;
+        float grayValue = 0.2126f * pixel[0] + 0.7152f * pixel[1] + 0.0722f * pixel[2];
+        gray[x] = static_cast<unsigned char>(grayValue);
+    }
+}
+
+/**
+ * Computes one row of signed gradients from the K smoothed rows under the kernel.
+ *
+ * Each row pointer points at pixel 0 of a row stored with K / 2 zeros before it and
+ * K - 1 - K / 2 zeros after it, and rows outside the image point at zeros, so pixels outside
+ * the image contribute nothing and the loop needs no bounds checks. Eight gradients are
+ * computed per step in 16-bit lanes: the largest, Scharr's 16 * 255, fits easily. The kernel
+ * weights are compile-time constants, so zero taps are skipped and the loops unroll.
+ *
+ * @param rows The K padded rows under the kernel, top to bottom.
+ * @param width The row width.
+ * @param gradientX The destination row of X gradients.
+ * @param gradientY The destination row of Y gradients.
+ */
+template <EdgeOperator Op>
+static void gradientRow(const unsigned char* const* rows, int width, int16_t* gradientX, int16_t* gradientY) {
+    using Kernels = GradientKernels<Op>;
+    const int K = Kernels::size;
+    const int anchor = K / 2;
+    int x = 0;
+#if defined(SIMDOPS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 8 <= width; x += 8) {
+        __m128i sumX = zero;
+        __m128i sumY = zero;
+        for (int ky = 0; ky < K; ++ky) {
+            for (int kx = 0; kx < K; ++kx) {
+                if (Kernels::x[ky][kx] == 0 && Kernels::y[ky][kx] == 0) {
+                    continue;
+                }
+                const unsigned char* source = rows[ky] + x + kx - anchor;
+                __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)), zero);
+                if (Kernels::x[ky][kx] != 0) {
+                    sumX = _mm_add_epi16(sumX, _mm_mullo_epi16(v, _mm_set1_epi16(Kernels::x[ky][kx])));
+                }
+                if (Kernels::y[ky][kx] != 0) {
+                    sumY = _mm_add_epi16(sumY, _mm_mullo_epi16(v, _mm_set1_epi16(Kernels::y[ky][kx])));
+                }
+            }
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gradientX + x), sumX);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gradientY + x), sumY);
+    }
+#endif
+    for (; x < width; ++x) {
+        int sumX = 0;
+        int sumY = 0;
+        for (int ky = 0; ky < K; ++ky) {
+            for (int kx = 0; kx < K; ++kx) {
+                int value = rows[ky][x + kx - anchor];
+                sumX += value * Kernels::x[ky][kx];
+                sumY += value * Kernels::y[ky][kx];
+            }
+        }
+        gradientX[x] = static_cast<int16_t>(sumX);
+        gradientY[x] = static_cast<int16_t>(sumY);
+    }
+}
+
+/**
+ * Converts one row of gradients to 8-bit output values.
+ *
+ * The exact magnitude takes its square root in single precision, which is exact here: below
+ * 255^2 every integer is representable and a correctly rounded root never crosses an integer,
+ * and anything larger saturates to 255 either way.
+ *
+ * @param output The kind of value to produce.
+ * @param gradientX The row of X gradients.
+ * @param gradientY The row of Y gradients.
+ * @param width The row width.
+ * @param out The destination row.
+ */
+static void outputRow(GradientOutput output, const int16_t* gradientX, const int16_t* gradientY, int width,
+                      unsigned char* out) {
+    int x = 0;
+    if (output == Direction) {
+        const float scale = 256.0f / (2.0f * static_cast<float>(M_PI));
+        for (; x < width; ++x) {
+            float angle = std::atan2(static_cast<float>(gradientY[x]), static_cast<float>(gradientX[x]));
+            out[x] = static_cast<unsigned char>(static_cast<int>((angle + static_cast<float>(M_PI)) * scale) & 255);
+        }
+        return;
+    }
+#if defined(SIMDOPS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 8 <= width; x += 8) {
+        __m128i gx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gradientX + x));
+        __m128i gy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gradientY + x));
+        __m128i result;
+        if (output == MagnitudeL2) {
+            // Interleaving Gx and Gy lets _mm_madd_epi16 form Gx^2 + Gy^2 in 32 bits
+            __m128i lo = _mm_unpacklo_epi16(gx, gy);
+            __m128i hi = _mm_unpackhi_epi16(gx, gy);
+            __m128i rootLo = _mm_cvttps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(lo, lo))));
+            __m128i rootHi = _mm_cvttps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(hi, hi))));
+            result = _mm_packs_epi32(rootLo, rootHi);
+        } else {
+            __m128i absX = _mm_max_epi16(gx, _mm_sub_epi16(zero, gx));
+            __m128i absY = _mm_max_epi16(gy, _mm_sub_epi16(zero, gy));
+            result = output == MagnitudeL1 ? _mm_adds_epi16(absX, absY) : _mm_max_epi16(absX, absY);
+        }
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(result, result));
+    }
+#endif
+    for (; x < width; ++x) {
+        int gx = gradientX[x];
+        int gy = gradientY[x];
+        int value;
+        if (output == MagnitudeL2) {
+            value = static_cast<int>(std::sqrt(gx * gx + gy * gy));
+        } else if (output == MagnitudeL1) {
+            value = std::abs(gx) + std::abs(gy);
+        } else {
+            value = std::max(std::abs(gx), std::abs(gy));
+        }
+        out[x] = static_cast<unsigned char>(std::min(value, 255));
+    }
+}
+
+/**
+ * Streams an image through grayscale conversion, the operator's optional 5x5 Gaussian blur and
+ * its gradient kernels, handing each row of signed gradients to sink(y, gradientX, gradientY).
+ *
+ * Each source row is converted to luma and fed to a GaussianRowFilter, whose output rows go into
+ * a ring of the last K smoothed rows; as soon as the K rows around row y are ready its gradients
+ * are computed. Only a few rows are kept, and the result is the same as running
+ * ColourCorrection(Grayscale), ImageBlur(Gaussian, 5) and the convolution one after the other.
+ *
+ * @param image The source image.
+ * @param sink Called once per row, top to bottom; the row buffers are reused afterwards.
+ */
+template <EdgeOperator Op, typename Sink>
+static void streamGradients(const Image& image, Sink&& sink) {
+    using Kernels = GradientKernels<Op>;
+    const int K = Kernels::size;
+    const int anchor = K / 2;
     int width = image.getWidth();
     int height = image.getHeight();
     int channels = image.getChannels();
-    unsigned char* data = image.getData();
-    std::vector<unsigned char> newData(width * height * channels);
+    const unsigned char* data = image.getData();
+
+    std::size_t rowLength = static_cast<std::size_t>(width) * channels;
+    std::size_t paddedLength = static_cast<std::size_t>(width) + K - 1;
+    std::vector<unsigned char> gray(width);
+    // Smoothed row r lives in slot r % K; the padding around each row stays zero
+    std::vector<unsigned char> smoothed(K * paddedLength, 0);
+    std::vector<unsigned char> zeros(paddedLength, 0);
+    std::vector<int16_t> gradientX(width);
+    std::vector<int16_t> gradientY(width);
+    GaussianRowFilter gaussian(width, height, 1, ImageBlur::gaussianWeights(5, 1.0f));
+    int smoothedRows = 0;
+
+    auto smoothNextRow = [&]() {
+        unsigned char* out = smoothed.data() + (smoothedRows % K) * paddedLength + anchor;
+        if (!Kernels::blur) {
+            lumaRow(data + smoothedRows * rowLength, width, channels, out);
+        } else {
+            while (gaussian.pushedRows() <= gaussian.lastRowNeeded(smoothedRows)) {
+                lumaRow(data + gaussian.pushedRows() * rowLength, width, channels, gray.data());
+                gaussian.pushRow(gray.data());
+            }
+            gaussian.blurRow(smoothedRows, out);
+        }
+        ++smoothedRows;
+    };
 
-    // Apply grayscale as preprocessing step
-    ColourCorrection grayscale(Grayscale);
-    grayscale.apply(image);
+    const unsigned char* rows[K];
+    for (int y = 0; y < height; ++y) {
+        while (smoothedRows <= std::min(y - anchor + K - 1, height - 1)) {
+            smoothNextRow();
+        }
+        for (int k = 0; k < K; ++k) {
+            int r = y - anchor + k;
+            const unsigned char* row = r >= 0 && r < height ? smoothed.data() + (r % K) * paddedLength : zeros.data();
+            rows[k] = row + anchor;
+        }
+        gradientRow<Op>(rows, width, gradientX.data(), gradientY.data());
+        sink(y, gradientX.data(), gradientY.data());
+    }
+}
 
-    // /* Gaussian blur is not applied for Roberts Cross as no blur produced better results.
-    // If the blur is applied too much noise is reduced; image appears very dark.*/
-    // // Apply Gaussian blur as preprocessing step
-    // ImageBlur blur(Gaussian, 5); // Adjust kernel size as needed
-    // blur.apply(image);
+/**
+ * Replaces an image by the selected output (magnitude or direction) of an operator's gradients.
+ *
+ * @param image The image to apply edge detection on; it becomes a single-channel image.
+ */
+template <EdgeOperator Op>
+void EdgeDetection::detectEdges(Image& image) {
+    int width = image.getWidth();
+    int height = image.getHeight();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
 
-    // Roberts Cross operator kernels
-    const std::vector<std::vector<int>> robertsKernelX = { {1, 0}, {0, -1} };
-    const std::vector<std::vector<int>> robertsKernelY = { {0, 1}, {-1, 0} };
+    unsigned char* result = static_cast<unsigned char*>(std::malloc(static_cast<std::size_t>(width) * height));
+    streamGradients<Op>(image, [&](int y, const int16_t* gradientX, const int16_t* gradientY) {
+        outputRow(output, gradientX, gradientY, width, result + static_cast<std::size_t>(y) * width);
+    });
 
-    // Apply Roberts Cross operator 
-    applyEdgeDetection(image, robertsKernelX, robertsKernelY);
+    // Image frees its data with free(), so the result is allocated with malloc()
+    image.updateData(result, width, height, 1);
 }
 
 /**
- * Generic function to apply edge detection using specified kernels.
- * This function convolves the image data with both X and Y kernels.
+ * Fills two planes with the signed gradients of an operator.
  *
- * @param image The image to apply edge detection on.
- * @param kernelX The kernel to convolve with in the X direction.
- * @param kernelY The kernel to convolve with in the Y direction.
+ * @param image The source image.
+ * @param gradientX Receives the X gradients, width * height values.
+ * @param gradientY Receives the Y gradients, width * height values.
  */
-void EdgeDetection::applyEdgeDetection(Image& image, const std::vector<std::vector<int>>& kernelX, const std::vector<std::vector<int>>& kernelY) {
-    int width = image.getWidth();
-    int height = image.getHeight();
-    int channels = image.getChannels();
-    unsigned char* data = image.getData();
+template <EdgeOperator Op>
+static void gradientPlanes(const Image& image, std::vector<int16_t>& gradientX, std::vector<int16_t>& gradientY) {
+    std::size_t width = static_cast<std::size_t>(std::max(image.getWidth(), 0));
+    gradientX.resize(width * std::max(image.getHeight(), 0));
+    gradientY.resize(gradientX.size());
+    streamGradients<Op>(image, [&](int y, const int16_t* rowX, const int16_t* rowY) {
+        std::copy(rowX, rowX + width, gradientX.begin() + y * width);
+        std::copy(rowY, rowY + width, gradientY.begin() + y * width);
+    });
+}
 
-    int kernelSize = kernelX.size(); // Assuming square kernel
+/**
+ * Computes the signed Gx and Gy planes of an image with the given operator, including its
+ * grayscale conversion and Gaussian blur, without modifying the image.
+ *
+ * @param image The source image.
+ * @param operatorType The gradient operator; Canny uses the Sobel gradients.
+ * @param gradientX Receives the X gradients, width * height values in row-major order.
+ * @param gradientY Receives the Y gradients, width * height values in row-major order.
+ */
+void EdgeDetection::computeGradients(const Image& image, EdgeOperator operatorType,
+                                     std::vector<int16_t>& gradientX, std::vector<int16_t>& gradientY) {
+    switch (operatorType) {
+    case Sobel:
+        gradientPlanes<Sobel>(image, gradientX, gradientY);
+        break;
+    case Prewitt:
+        gradientPlanes<Prewitt>(image, gradientX, gradientY);
+        break;
+    case Scharr:
+        gradientPlanes<Scharr>(image, gradientX, gradientY);
+        break;
+    case RobertsCross:
+        gradientPlanes<RobertsCross>(image, gradientX, gradientY);
+        break;
+    case Canny:
+        gradientPlanes<Sobel>(image, gradientX, gradientY);
+        break;
+    }
+}
 
-    // Create a vector to store the new pixel data
-    std::vector<unsigned char> newData(width * height * channels);
+// Labels of the non-maximum suppression pass
+static const unsigned char notEdge = 0;
+static const unsigned char weakEdge = 1;
+static const unsigned char strongEdge = 2;
 
-    // Iterate over each pixel
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            for (int c = 0; c < channels; ++c) {
-                int gradientX = 0;
-                int gradientY = 0;
-
-                // Convolve with kernel
-                for (int ky = 0; ky < kernelSize; ++ky) {
-                    for (int kx = 0; kx < kernelSize; ++kx) {
-                        int nx = x + kx - kernelSize / 2;
-                        int ny = y + ky - kernelSize / 2;
-
-                        // Ensure pixel coordinates are within bounds
-                        if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                            int index = (ny * width + nx) * channels + c;
-                            gradientX += data[index] * kernelX[ky][kx];
-                            gradientY += data[index] * kernelY[ky][kx];
-                        }
-                    }
+// Edge length, in pixels, of the tiles that non-maximum suppression is split into
+static const int suppressionTile = 64;
+
+/**
+ * Thins the gradient magnitude to one-pixel-wide ridges and labels what is left.
+ *
+ * The gradient direction is rounded to the nearest of four axes (horizontal, vertical and the
+ * two diagonals) with integer slope tests (tan 22.5 degrees ~ 0.414), and a pixel survives only
+ * if its magnitude is above the neighbour before it along that axis and not below the one
+ * after it, so flat ridges stay one pixel wide. Survivors are labelled strong or weak against
+ * the thresholds. Magnitudes are compared squared, so no square roots are taken. Tiles are
+ * independent and are processed in parallel; pixels on the image border are never edges.
+ *
+ * @param gradientX The X gradients.
+ * @param gradientY The Y gradients.
+ * @param width The image width.
+ * @param height The image height.
+ * @param lowSquared The squared low threshold.
+ * @param highSquared The squared high threshold.
+ * @param labels Receives notEdge, weakEdge or strongEdge per pixel.
+ */
+static void suppressNonMaxima(const std::vector<int16_t>& gradientX, const std::vector<int16_t>& gradientY,
+                              int width, int height, int32_t lowSquared, int32_t highSquared,
+                              std::vector<unsigned char>& labels) {
+    auto magnitude = [&](std::size_t i) {
+        int32_t gx = gradientX[i];
+        int32_t gy = gradientY[i];
+        return gx * gx + gy * gy;
+    };
+
+    int tilesX = (width + suppressionTile - 1) / suppressionTile;
+    int tilesY = (height + suppressionTile - 1) / suppressionTile;
+    Parallel::parallelFor(0, tilesX * tilesY, [&](int tile) {
+        int x0 = (tile % tilesX) * suppressionTile;
+        int y0 = (tile / tilesX) * suppressionTile;
+        int x1 = std::min(x0 + suppressionTile, width);
+        int y1 = std::min(y0 + suppressionTile, height);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                std::size_t i = static_cast<std::size_t>(y) * width + x;
+                labels[i] = notEdge;
+                if (x == 0 || y == 0 || x == width - 1 || y == height - 1) {
+                    continue;
+                }
+                int32_t m = magnitude(i);
+                if (m < lowSquared) {
+                    continue;
+                }
+
+                int gx = gradientX[i];
+                int gy = gradientY[i];
+                int ax = std::abs(gx);
+                int ay = std::abs(gy);
+                std::ptrdiff_t step;
+                if (ay * 1000 <= ax * 414) {
+                    step = 1; // gradient along x
+                } else if (ax * 1000 <= ay * 414) {
+                    step = width; // gradient along y
+                } else if ((gx > 0) == (gy > 0)) {
+                    step = width + 1; // down-right diagonal
+                } else {
+                    step = width - 1; // down-left diagonal
                 }
+                if (m > magnitude(i - step) && m >= magnitude(i + step)) {
+                    labels[i] = m >= highSquared ? strongEdge : weakEdge;
+                }
+            }
+        }
+    });
+}
+
+/**
+ * Applies the Canny edge detector to an image.
+ *
+ * The image goes through the Sobel pipeline (grayscale, 5x5 Gaussian blur and gradients),
+ * non-maximum suppression thins the gradient magnitude to ridges, and hysteresis keeps the
+ * strong ridge pixels plus every weak one connected to them. Hysteresis is a flood fill from
+ * the strong pixels with an explicit stack, so long edges cannot overflow the call stack.
+ * The result is a single-channel image with edges at 255 and everything else at 0.
+ *
+ * @param image The image to apply the Canny detector on.
+ */
+void EdgeDetection::applyCanny(Image& image) {
+    int width = image.getWidth();
+    int height = image.getHeight();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
 
-                // Compute gradient magnitude
-                int gradientMagnitude = std::sqrt(gradientX * gradientX + gradientY * gradientY);
+    std::vector<int16_t> gradientX;
+    std::vector<int16_t> gradientY;
+    computeGradients(image, Sobel, gradientX, gradientY);
+
+    // Clamped to the Sobel range so that the squared thresholds cannot overflow
+    int32_t low = std::min(std::max(lowThreshold, 0), maxGradientMagnitude);
+    int32_t high = std::min(std::max(highThreshold, low), maxGradientMagnitude);
+    std::vector<unsigned char> labels(static_cast<std::size_t>(width) * height);
+    suppressNonMaxima(gradientX, gradientY, width, height, low * low, high * high, labels);
+
+    std::size_t pixelCount = labels.size();
+    unsigned char* result = static_cast<unsigned char*>(std::malloc(pixelCount));
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < pixelCount; ++i) {
+        result[i] = labels[i] == strongEdge ? 255 : 0;
+        if (labels[i] == strongEdge) {
+            pending.push_back(i);
+        }
+    }
 
-                // Store gradient magnitude in newData
-                newData[(y * width + x) * channels + c] = std::min(std::max(gradientMagnitude, 0), 255);
+    // Only interior pixels carry labels, so the neighbours of a pending pixel are all in bounds
+    const std::ptrdiff_t stride = width;
+    const std::ptrdiff_t neighbours[8] = { -stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1 };
+    while (!pending.empty()) {
+        std::size_t i = pending.back();
+        pending.pop_back();
+        for (std::ptrdiff_t offset : neighbours) {
+            std::size_t n = i + offset;
+            if (labels[n] == weakEdge) {
+                labels[n] = strongEdge;
+                result[n] = 255;
+                pending.push_back(n);
             }
         }
     }
 
-    // Copy newData back to image data
-    std::copy(newData.begin(), newData.end(), data);
+    // Image frees its data with free(), so the result is allocated with malloc()
+    image.updateData(result, width, height, 1);
 }
 
 /**
@@ -275,6 +583,10 @@ void EdgeDetection::applyEdge(Image& image, int choice) {
         operatorType = RobertsCross;
         applyRobertsCross(image);
         break;
+    case 5:
+        operatorType = Canny;
+        applyCanny(image);
+        break;
     default:
         std::cerr << "Invalid choice." << std::endl;
         return;
@@ -298,6 +610,8 @@ EdgeOperator EdgeDetection::getEdgeOperatorFromChoice(int choice) {
         return Scharr;
     case 4:
         return RobertsCross;
+    case 5:
+        return Canny;
     default:
         throw std::invalid_argument("Invalid choice for edge detection");
     }
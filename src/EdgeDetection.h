@@ -5,7 +5,7 @@
  *
  * The EdgeDetection class provides a comprehensive solution for detecting edges in images. It
  * extends from the Filter base class and overrides the apply method to implement edge detection.
- * Supported edge detection methods include Sobel, Prewitt, Scharr, and Roberts Cross. This class
+ * Supported edge detection methods include Sobel, Prewitt, Scharr, Roberts Cross and Canny. This class
  * allows users to select and apply these methods to any image, facilitating the extraction of
  * structural information from images.
  *
@@ -16,6 +16,8 @@
  *   - Supports multiple edge detection algorithms.
  *   - Inherits from the Filter class and overrides the apply method.
  *   - Offers a method to choose an edge detection algorithm based on user input.
+ *   - Outputs the exact or approximate gradient magnitude, the gradient direction, or the raw
+ *     signed Gx/Gy planes.
  *
  * @note The Image class is required for applying edge detection methods. The effectiveness of each
  *       method may vary depending on the image and the specific requirements of the application.
@@ -24,6 +26,7 @@
  *         Group: selection sort.
  * Structure:
  *   EdgeDetection
+ *   |-- canny
  *   |-- prewitt
  *   |-- robertscross
  *   |-- scharr
@@ -35,17 +38,64 @@
 
 #include "Filter.h"
 #include "Image.h"
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
 
 
-enum EdgeOperator { Sobel, Prewitt, Scharr, RobertsCross };
+enum EdgeOperator { Sobel, Prewitt, Scharr, RobertsCross, Canny };
+
+// What the filtered image holds for every pixel
+enum GradientOutput {
+    MagnitudeL2,   // exact sqrt(Gx^2 + Gy^2), truncated and clamped to 255
+    MagnitudeL1,   // |Gx| + |Gy|, clamped to 255
+    MagnitudeMax,  // max(|Gx|, |Gy|), clamped to 255
+    Direction      // atan2(Gy, Gx) mapped from [-pi, pi) to [0, 256)
+};
+
+// Kernels of each operator, known at compile time so that the convolution unrolls and zero
+// taps disappear. The window of a size-K kernel covers offsets -K / 2 .. K - 1 - K / 2 on both axes.
+template <EdgeOperator Op> struct GradientKernels;
+
+template <> struct GradientKernels<Sobel> {
+    static constexpr int size = 3;
+    static constexpr bool blur = true;
+    static constexpr int x[3][3] = { {-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1} };
+    static constexpr int y[3][3] = { {-1, -2, -1}, {0, 0, 0}, {1, 2, 1} };
+};
+
+template <> struct GradientKernels<Prewitt> {
+    static constexpr int size = 3;
+    static constexpr bool blur = true;
+    static constexpr int x[3][3] = { {-1, 0, 1}, {-1, 0, 1}, {-1, 0, 1} };
+    static constexpr int y[3][3] = { {-1, -1, -1}, {0, 0, 0}, {1, 1, 1} };
+};
+
+template <> struct GradientKernels<Scharr> {
+    static constexpr int size = 3;
+    static constexpr bool blur = true;
+    static constexpr int x[3][3] = { {-3, 0, 3}, {-10, 0, 10}, {-3, 0, 3} };
+    static constexpr int y[3][3] = { {-3, -10, -3}, {0, 0, 0}, {3, 10, 3} };
+};
+
+// Gaussian blur is not applied for Roberts Cross as no blur produced better results.
+template <> struct GradientKernels<RobertsCross> {
+    static constexpr int size = 2;
+    static constexpr bool blur = false;
+    static constexpr int x[2][2] = { {1, 0}, {0, -1} };
+    static constexpr int y[2][2] = { {0, 1}, {-1, 0} };
+};
 
 
 class EdgeDetection : public Filter {
 public:
-    EdgeDetection(EdgeOperator operatorType);
+    EdgeDetection(EdgeOperator operatorType, GradientOutput output = MagnitudeL2);
+    // Largest Sobel gradient magnitude, 1020 * sqrt(2) rounded up; the range of the Canny thresholds
+    static constexpr int maxGradientMagnitude = 1443;
+
+    // Canny with hysteresis thresholds on the Sobel gradient magnitude (0 to maxGradientMagnitude)
+    EdgeDetection(EdgeOperator operatorType, int lowThreshold, int highThreshold);
     virtual ~EdgeDetection();
 
     void apply(Image& image) override;
@@ -53,17 +103,26 @@ public:
 
     static EdgeOperator getEdgeOperatorFromChoice(int choice);
 
+    // Signed gradient planes (width * height each, row-major) of the grayscale, smoothed image,
+    // for consumers that need more than the magnitude. The image is not modified.
+    static void computeGradients(const Image& image, EdgeOperator operatorType,
+                                 std::vector<int16_t>& gradientX, std::vector<int16_t>& gradientY);
+
 private:
     EdgeOperator operatorType;
+    GradientOutput output;
+    int lowThreshold, highThreshold;
 
-    // Declare helper function
-    static void applyEdgeDetection(Image& image, const std::vector<std::vector<int>>& kernelX, const std::vector<std::vector<int>>& kernelY);
+    // Fused grayscale conversion, optional 5x5 Gaussian blur and gradient output
+    template <EdgeOperator Op>
+    void detectEdges(Image& image);
 
     // Declare other private methods for individual edge detection algorithms
     void applySobel(Image& image);
     void applyPrewitt(Image& image);
     void applyScharr(Image& image);
     void applyRobertsCross(Image& image);
+    void applyCanny(Image& image);
 };
 
 #endif // EDGE_DETECTION_H
\ No newline at end of file
@@ -5,8 +5,16 @@
  *         Group: selection sort.
  */
 #include "EdgeDetectionTest.h"
+#include "ColourCorrection.h"
+#include "ImageBlur.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <cmath>
+#include <random>
 #include <vector>
 
 void EdgeDetectionTest::run(int testType) {
@@ -24,6 +32,12 @@ void EdgeDetectionTest::run(int testType) {
         case TestRobertsCross:
             testRobertsCross();
             break;
+        case TestCanny:
+            testCanny();
+            break;
+        case TestGradientOutputs:
+            testGradientOutputs();
+            break;
         default:
             std::cerr << "Unknown edge detection test type provided." << std::endl;
             break;
@@ -192,4 +206,180 @@ void EdgeDetectionTest::testRobertsCross() {
     } else {
         std::cerr << "Roberts Cross Edge Detection Test Failed: Average gradient magnitude did not increase as expected, indicating a potential issue with edge enhancement." << originalAvgGradient << " to " << robertsCrossAvgGradient << "."<< std::endl;
     }
+}
+
+// This function tests the Canny edge detector. Canny does not enhance gradients like the operators
+// above; it marks edge pixels, so the test checks the properties of that edge map instead:
+//   - the output is single-channel and binary (every pixel is 0 or 255);
+//   - on a bright square on a dark background, non-maximum suppression leaves edges exactly one
+//     pixel wide, i.e. each row and column away from the corners crosses exactly two edge pixels;
+//   - the result on gracehopper.png is byte-identical with 1 and 7 worker threads.
+void EdgeDetectionTest::testCanny() {
+    // Bright square on a dark background
+    const int size = 64, squareBegin = 16, squareEnd = 48;
+    unsigned char* squareData = static_cast<unsigned char*>(std::malloc(size * size));
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            bool inside = x >= squareBegin && x < squareEnd && y >= squareBegin && y < squareEnd;
+            squareData[y * size + x] = inside ? 200 : 50;
+        }
+    }
+    Image square;
+    square.updateData(squareData, size, size, 1);
+    EdgeDetection(Canny, 40, 100).apply(square);
+    const unsigned char* edges = square.getData();
+
+    bool binary = square.getChannels() == 1;
+    for (int i = 0; i < size * size && binary; ++i) {
+        binary = edges[i] == 0 || edges[i] == 255;
+    }
+
+    // Rows and columns at least 4 pixels from the corners only cross the two straight sides
+    bool thin = true;
+    for (int k = squareBegin + 4; k < squareEnd - 4 && thin; ++k) {
+        int rowEdges = 0, columnEdges = 0;
+        for (int j = 0; j < size; ++j) {
+            rowEdges += edges[k * size + j] == 255;
+            columnEdges += edges[j * size + k] == 255;
+        }
+        thin = rowEdges == 2 && columnEdges == 2;
+    }
+
+    // The same photograph with one and with several worker threads
+    Image single, multi;
+    if (!single.loadImage("../Images/gracehopper.png") || !multi.loadImage("../Images/gracehopper.png")) {
+        std::cerr << "Failed to load image for Canny test." << std::endl;
+        return;
+    }
+    int previousThreads = Parallel::getThreadCount();
+    Parallel::setThreadCount(1);
+    EdgeDetection(Canny, 40, 100).apply(single);
+    Parallel::setThreadCount(7);
+    EdgeDetection(Canny, 40, 100).apply(multi);
+    Parallel::setThreadCount(previousThreads);
+
+    std::size_t pixelCount = static_cast<std::size_t>(single.getWidth()) * single.getHeight();
+    bool identical = multi.getChannels() == 1 && single.getChannels() == 1 &&
+                     std::memcmp(single.getData(), multi.getData(), pixelCount) == 0;
+    for (std::size_t i = 0; i < pixelCount && binary; ++i) {
+        binary = single.getData()[i] == 0 || single.getData()[i] == 255;
+    }
+
+    if (binary && thin && identical) {
+        std::cout << "Canny Edge Detection Test Passed: The output is binary, the edges of a synthetic square are one pixel wide, "
+                  << "and gracehopper.png gives the same edges with 1 and 7 threads." << std::endl;
+    } else {
+        std::cerr << "Canny Edge Detection Test Failed:"
+                  << (binary ? "" : " the output is not a binary single-channel image.")
+                  << (thin ? "" : " the edges of a synthetic square are not one pixel wide.")
+                  << (identical ? "" : " the result differs between 1 and 7 threads.") << std::endl;
+    }
+}
+
+template <EdgeOperator Op>
+void EdgeDetectionTest::referenceGradients(const Image& gray, std::vector<int>& gradientX, std::vector<int>& gradientY) {
+    using Kernels = GradientKernels<Op>;
+    const int K = Kernels::size;
+    int width = gray.getWidth();
+    int height = gray.getHeight();
+    gradientX.assign(static_cast<std::size_t>(width) * height, 0);
+    gradientY.assign(gradientX.size(), 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int ky = 0; ky < K; ++ky) {
+                for (int kx = 0; kx < K; ++kx) {
+                    // Pixels outside the image count as zero
+                    int sy = y + ky - K / 2;
+                    int sx = x + kx - K / 2;
+                    if (sy < 0 || sy >= height || sx < 0 || sx >= width) {
+                        continue;
+                    }
+                    int value = gray.getData()[sy * width + sx];
+                    gradientX[y * width + x] += value * Kernels::x[ky][kx];
+                    gradientY[y * width + x] += value * Kernels::y[ky][kx];
+                }
+            }
+        }
+    }
+}
+
+// This function tests the gradient outputs against a scalar reference. A random colour image is
+// converted with ColourCorrection(Grayscale), blurred with ImageBlur(Gaussian, 5) for the operators
+// that blur, and convolved pixel by pixel. For Sobel, Prewitt, Scharr and Roberts Cross,
+// computeGradients() must return exactly those Gx and Gy planes, and the L2, L1 and Max outputs
+// must equal truncated sqrt(Gx^2 + Gy^2), |Gx| + |Gy| and max(|Gx|, |Gy|) clamped to 255. The
+// direction is computed in double precision here, so it may differ by one step where an angle
+// falls on a boundary between two of the 256 steps; Canny must use the Sobel gradients.
+void EdgeDetectionTest::testGradientOutputs() {
+    const int width = 67, height = 43, channels = 3;
+    std::size_t size = static_cast<std::size_t>(width) * height * channels;
+    std::mt19937 random(2024);
+    std::vector<unsigned char> pixels(size);
+    for (unsigned char& pixel : pixels) {
+        pixel = static_cast<unsigned char>(random());
+    }
+    auto makeImage = [&]() {
+        unsigned char* data = static_cast<unsigned char*>(std::malloc(size));
+        std::memcpy(data, pixels.data(), size);
+        Image image;
+        image.updateData(data, width, height, channels);
+        return image;
+    };
+
+    int planeMismatches = 0, outputMismatches = 0;
+    auto checkOperator = [&](EdgeOperator op, bool blur, auto gradients) {
+        Image gray = makeImage();
+        ColourCorrection(Grayscale).apply(gray);
+        if (blur) {
+            ImageBlur(Gaussian, 5).apply(gray);
+        }
+        std::vector<int> referenceX, referenceY;
+        gradients(gray, referenceX, referenceY);
+
+        Image source = makeImage();
+        std::vector<int16_t> gradientX, gradientY;
+        EdgeDetection::computeGradients(source, op, gradientX, gradientY);
+        planeMismatches += !std::equal(referenceX.begin(), referenceX.end(), gradientX.begin(), gradientX.end()) ||
+                           !std::equal(referenceY.begin(), referenceY.end(), gradientY.begin(), gradientY.end());
+
+        const GradientOutput outputs[] = { MagnitudeL2, MagnitudeL1, MagnitudeMax, Direction };
+        for (GradientOutput output : outputs) {
+            Image image = makeImage();
+            EdgeDetection(op, output).apply(image);
+            for (std::size_t i = 0; i < referenceX.size(); ++i) {
+                int gx = referenceX[i], gy = referenceY[i];
+                int expected;
+                if (output == MagnitudeL2) {
+                    expected = std::min(static_cast<int>(std::sqrt(static_cast<double>(gx * gx + gy * gy))), 255);
+                } else if (output == MagnitudeL1) {
+                    expected = std::min(std::abs(gx) + std::abs(gy), 255);
+                } else if (output == MagnitudeMax) {
+                    expected = std::min(std::max(std::abs(gx), std::abs(gy)), 255);
+                } else {
+                    expected = static_cast<int>((std::atan2(gy, gx) + M_PI) * 256.0 / (2.0 * M_PI)) & 255;
+                }
+                int difference = std::abs(image.getData()[i] - expected);
+                outputMismatches += output == Direction ? std::min(difference, 256 - difference) > 1 : difference != 0;
+            }
+        }
+    };
+    checkOperator(Sobel, true, referenceGradients<Sobel>);
+    checkOperator(Prewitt, true, referenceGradients<Prewitt>);
+    checkOperator(Scharr, true, referenceGradients<Scharr>);
+    checkOperator(RobertsCross, false, referenceGradients<RobertsCross>);
+
+    // Canny's gradient planes are Sobel's
+    Image source = makeImage();
+    std::vector<int16_t> sobelX, sobelY, cannyX, cannyY;
+    EdgeDetection::computeGradients(source, Sobel, sobelX, sobelY);
+    EdgeDetection::computeGradients(source, Canny, cannyX, cannyY);
+    planeMismatches += sobelX != cannyX || sobelY != cannyY;
+
+    if (planeMismatches == 0 && outputMismatches == 0) {
+        std::cout << "Gradient Outputs Test Passed: The gradient planes and the L2, L1, Max and direction outputs of "
+                  << "every operator match a scalar reference on a random 67x43 image." << std::endl;
+    } else {
+        std::cerr << "Gradient Outputs Test Failed: " << planeMismatches << " gradient planes and " << outputMismatches
+                  << " output pixels differ from a scalar reference." << std::endl;
+    }
 }
\ No newline at end of file
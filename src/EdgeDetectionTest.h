@@ -10,13 +10,16 @@
 #include "Test.h"
 #include "Image.h"
 #include "EdgeDetection.h"
+#include <vector>
 
 // Enum defining the types of edge detection tests that can be run.
 enum EdgeDetectionTestType {
     TestSobel, // Test for Sobel edge detection.
     TestPrewitt, // Test for Prewitt edge detection.
     TestScharr, // Test for Scharr edge detection.
-    TestRobertsCross // Test for Roberts Cross edge detection.
+    TestRobertsCross, // Test for Roberts Cross edge detection.
+    TestCanny, // Test for Canny edge detection.
+    TestGradientOutputs // Test for the magnitude and direction outputs and the gradient planes.
 };
 
 class EdgeDetectionTest : public Test {
@@ -29,6 +32,12 @@ private:
     void testPrewitt(); // Tests Prewitt edge detection method.
     void testScharr(); // Tests Scharr edge detection method.
     void testRobertsCross(); // Tests Roberts Cross edge detection method.
+    void testCanny(); // Tests Canny edge detection method.
+    void testGradientOutputs(); // Tests every gradient output of every operator against a scalar reference.
+
+    // Gx and Gy of a grayscale (and, for operators that blur, Gaussian-smoothed) image, one pixel at a time.
+    template <EdgeOperator Op>
+    static void referenceGradients(const Image& gray, std::vector<int>& gradientX, std::vector<int>& gradientY);
 };
 
 #endif // EDGE_DETECTION_TEST_H
\ No newline at end of file
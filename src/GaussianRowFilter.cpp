@@ -0,0 +1,83 @@
+/**
+ * @file GaussianRowFilter.cpp
+ *
+ * @brief Implementation of the streaming separable Gaussian blur.
+ *
+ * Weights are Q14 (16384 = 1.0), so a tap product fits in 32 bits in both passes:
+ * 255 * 16384 in the horizontal pass and (255 << 7) * 16384 in the vertical pass.
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#include "GaussianRowFilter.h"
+#include "SimdOps.h"
+#include <algorithm>
+
+/**
+ * Constructor: Prepares the row buffers for an image of the given size.
+ *
+ * @param width The image width.
+ * @param height The image height.
+ * @param channels The number of interleaved channels.
+ * @param weights Odd-length Q14 weights, e.g. from ImageBlur::gaussianWeights.
+ */
+GaussianRowFilter::GaussianRowFilter(int width, int height, int channels, const std::vector<int16_t>& weights)
+    : width(width), height(height), channels(channels),
+      taps(static_cast<int>(weights.size())), halfKernel(static_cast<int>(weights.size()) / 2), rowsPushed(0),
+      rowLength(static_cast<std::size_t>(width) * channels), weights(weights),
+      padded(static_cast<std::size_t>(width + 2 * halfKernel) * channels),
+      ring(static_cast<std::size_t>(taps) * width * channels), tapRows(taps) {}
+
+/**
+ * Gets the last source row needed by an output row.
+ *
+ * @param y The output row.
+ * @return min(y + k / 2, height - 1).
+ */
+int GaussianRowFilter::lastRowNeeded(int y) const {
+    return std::min(y + halfKernel, height - 1);
+}
+
+/**
+ * Runs the horizontal pass on the next source row and stores the Q7 result in the ring.
+ *
+ * The row is copied into a 16-bit buffer padded with replicated border pixels, so the taps need
+ * no bounds checks. convolveRows16 works on the interleaved channels directly: for pixel data
+ * with C channels, tap t of element i is element i + t * C of the padded row.
+ *
+ * @param row The source row, width * channels bytes.
+ */
+void GaussianRowFilter::pushRow(const unsigned char* row) {
+    int16_t* interior = padded.data() + halfKernel * channels;
+    for (std::size_t i = 0; i < rowLength; ++i) {
+        interior[i] = row[i];
+    }
+    for (int x = 1; x <= halfKernel; ++x) {
+        for (int c = 0; c < channels; ++c) {
+            interior[-x * channels + c] = row[c];
+            interior[(width - 1 + x) * channels + c] = row[(width - 1) * channels + c];
+        }
+    }
+    for (int t = 0; t < taps; ++t) {
+        tapRows[t] = padded.data() + t * channels;
+    }
+    int16_t* out = ring.data() + static_cast<std::size_t>(rowsPushed % taps) * rowLength;
+    SimdOps::convolveRows16(tapRows.data(), weights.data(), taps, rowLength, 14 - 7, out);
+    ++rowsPushed;
+}
+
+/**
+ * Runs the vertical pass for an output row, replicating the first and last rows at the edges.
+ *
+ * @param y The output row.
+ * @param out The destination row, width * channels bytes; may be source row y itself.
+ */
+void GaussianRowFilter::blurRow(int y, unsigned char* out) {
+    for (int t = 0; t < taps; ++t) {
+        int sourceRow = std::min(std::max(y + t - halfKernel, 0), height - 1);
+        tapRows[t] = ring.data() + static_cast<std::size_t>(sourceRow % taps) * rowLength;
+    }
+    SimdOps::convolveRows16To8(tapRows.data(), weights.data(), taps, rowLength, 14 + 7, out);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file GaussianRowFilter.h
+ *
+ * @brief Streaming separable Gaussian blur that works on a few rows at a time.
+ *
+ * GaussianRowFilter blurs an image that is fed to it row by row. Each pushed row goes through
+ * the horizontal pass straight away and is kept, as 16-bit Q7 values, in a ring of k rows; an
+ * output row is produced by the vertical pass as soon as the k rows around it are in the ring.
+ * Only k rows are ever stored, so the blur can be fused with the steps before and after it
+ * (e.g. grayscale conversion and gradients) without full-image temporaries.
+ *
+ * The arithmetic is ImageBlur's fixed-point Gaussian: Q14 weights from ImageBlur::gaussianWeights,
+ * replicated border pixels, and SimdOps::convolveRows16 / convolveRows16To8 for both passes.
+ *
+ * Usage:
+ *   GaussianRowFilter blur(width, height, channels, ImageBlur::gaussianWeights(5, 1.0f));
+ *   for (int y = 0; y < height; ++y) {
+ *       while (blur.pushedRows() <= blur.lastRowNeeded(y)) {
+ *           blur.pushRow(source + blur.pushedRows() * rowLength);
+ *       }
+ *       blur.blurRow(y, output + y * rowLength);
+ *   }
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef GAUSSIANROWFILTER_H
+#define GAUSSIANROWFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GaussianRowFilter {
+public:
+    GaussianRowFilter(int width, int height, int channels, const std::vector<int16_t>& weights);
+
+    // Number of source rows pushed so far; the next pushRow() takes source row pushedRows().
+    int pushedRows() const { return rowsPushed; }
+
+    // Last source row that must have been pushed before output row y can be blurred.
+    int lastRowNeeded(int y) const;
+
+    // Runs the horizontal pass on the next source row (width * channels bytes).
+    void pushRow(const unsigned char* row);
+
+    // Writes output row y. Source rows up to lastRowNeeded(y) must have been pushed, and no more
+    // than k rows past y - k / 2, so that every row the window needs is still in the ring.
+    void blurRow(int y, unsigned char* out);
+
+private:
+    int width, height, channels;
+    int taps, halfKernel;
+    int rowsPushed;
+    std::size_t rowLength;
+    std::vector<int16_t> weights;
+    std::vector<int16_t> padded;  // one source row with halfKernel replicated pixels on each side
+    std::vector<int16_t> ring;    // taps rows of horizontal pass results; row r lives in slot r % taps
+    std::vector<const int16_t*> tapRows;
+};
+
+#endif // GAUSSIANROWFILTER_H
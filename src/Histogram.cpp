@@ -0,0 +1,288 @@
+/**
+ * @file Histogram.cpp
+ *
+ * @brief Implementation of the parallel histograms and their statistics.
+ *
+ * Per-thread bins are 32-bit, which is enough for 2^32 samples per copy of a bin, i.e. images
+ * and volumes of over 16 billion voxels per thread; the merged bins are 64-bit.
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#include "Histogram.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Constructor: Creates an empty histogram.
+ *
+ * @param channels The number of channels.
+ */
+Histogram::Histogram(int channels) : channels(channels), counts(static_cast<std::size_t>(channels) * 256, 0) {}
+
+/**
+ * Constructor: Counts every channel of an image.
+ *
+ * @param image The image.
+ * @param threadCount The number of threads to use (0 for the default).
+ */
+Histogram::Histogram(const Image& image, int threadCount) : Histogram(image.getChannels()) {
+    countChannels(image.getData(), static_cast<std::size_t>(image.getWidth()) * image.getHeight(), threadCount);
+}
+
+/**
+ * Constructor: Counts every channel of a volume.
+ *
+ * @param volume The volume.
+ * @param threadCount The number of threads to use (0 for the default).
+ */
+Histogram::Histogram(const Volume& volume, int threadCount) : Histogram(volume.getChannels()) {
+    // An empty volume has no channels, so the pixel count must not come from dividing by them
+    std::size_t pixelCount = static_cast<std::size_t>(volume.getWidth()) * volume.getHeight() * volume.getDepth();
+    countChannels(volume.getData(), pixelCount, threadCount);
+}
+
+/**
+ * Constructor: Counts every channel of raw interleaved pixels.
+ *
+ * @param data The pixel data.
+ * @param pixelCount The number of pixels.
+ * @param channels The number of interleaved channels.
+ * @param threadCount The number of threads to use (0 for the default).
+ */
+Histogram::Histogram(const unsigned char* data, std::size_t pixelCount, int channels, int threadCount)
+    : Histogram(channels) {
+    countChannels(data, pixelCount, threadCount);
+}
+
+/**
+ * Fills the bins of every channel, spreading consecutive pixels over the bin copies.
+ *
+ * @param data The pixel data.
+ * @param pixelCount The number of pixels.
+ * @param threadCount The number of threads to use (0 for the default).
+ */
+void Histogram::countChannels(const unsigned char* data, std::size_t pixelCount, int threadCount) {
+    int c = channels;
+    std::size_t binsPerCopy = static_cast<std::size_t>(c) * 256;
+    fill(pixelCount, [&](std::size_t begin, std::size_t end, uint32_t* bins) {
+        const unsigned char* pixel = data + begin * c;
+        std::size_t p = begin;
+        if (c == 1) {
+            for (; p + binCopies <= end; p += binCopies, pixel += binCopies) {
+                bins[pixel[0]]++;
+                bins[256 + pixel[1]]++;
+                bins[512 + pixel[2]]++;
+                bins[768 + pixel[3]]++;
+            }
+        } else {
+            for (; p + binCopies <= end; p += binCopies) {
+                for (int copy = 0; copy < binCopies; ++copy, pixel += c) {
+                    uint32_t* copyBins = bins + copy * binsPerCopy;
+                    for (int ch = 0; ch < c; ++ch) {
+                        copyBins[ch * 256 + pixel[ch]]++;
+                    }
+                }
+            }
+        }
+        for (; p < end; ++p, pixel += c) {
+            for (int ch = 0; ch < c; ++ch) {
+                bins[ch * 256 + pixel[ch]]++;
+            }
+        }
+    }, threadCount);
+}
+
+/**
+ * Gets the number of samples of a channel.
+ *
+ * @param channel The channel.
+ * @return The sum of its bins.
+ */
+uint64_t Histogram::total(int channel) const {
+    uint64_t sum = 0;
+    for (int v = 0; v < 256; ++v) {
+        sum += count(channel, v);
+    }
+    return sum;
+}
+
+/**
+ * Adds the channels together.
+ *
+ * @return A single-channel histogram of all samples.
+ */
+Histogram Histogram::merged() const {
+    Histogram all(1);
+    for (int ch = 0; ch < channels; ++ch) {
+        for (int v = 0; v < 256; ++v) {
+            all.counts[v] += count(ch, v);
+        }
+    }
+    return all;
+}
+
+/**
+ * Computes the mean value of a channel.
+ *
+ * @param channel The channel.
+ * @return The mean, or 0 for an empty histogram.
+ */
+double Histogram::mean(int channel) const {
+    uint64_t samples = 0, sum = 0;
+    for (int v = 0; v < 256; ++v) {
+        samples += count(channel, v);
+        sum += count(channel, v) * v;
+    }
+    return samples == 0 ? 0.0 : static_cast<double>(sum) / samples;
+}
+
+/**
+ * Computes the population variance of a channel.
+ *
+ * @param channel The channel.
+ * @return The variance, or 0 for an empty histogram.
+ */
+double Histogram::variance(int channel) const {
+    uint64_t samples = total(channel);
+    if (samples == 0) {
+        return 0.0;
+    }
+    double average = mean(channel);
+    double sum = 0.0;
+    for (int v = 0; v < 256; ++v) {
+        sum += (v - average) * (v - average) * count(channel, v);
+    }
+    return sum / samples;
+}
+
+/**
+ * Computes the population standard deviation of a channel.
+ *
+ * @param channel The channel.
+ * @return The standard deviation, or 0 for an empty histogram.
+ */
+double Histogram::standardDeviation(int channel) const {
+    return std::sqrt(variance(channel));
+}
+
+/**
+ * Finds the smallest value of a channel.
+ *
+ * @param channel The channel.
+ * @return The smallest value with a non-zero count, or 0 for an empty histogram.
+ */
+int Histogram::minimum(int channel) const {
+    for (int v = 0; v < 256; ++v) {
+        if (count(channel, v) != 0) {
+            return v;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Finds the largest value of a channel.
+ *
+ * @param channel The channel.
+ * @return The largest value with a non-zero count, or 0 for an empty histogram.
+ */
+int Histogram::maximum(int channel) const {
+    for (int v = 255; v >= 0; --v) {
+        if (count(channel, v) != 0) {
+            return v;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Finds a percentile of a channel, with the rank convention of RankFilter.
+ *
+ * @param channel The channel.
+ * @param percent The percentile, from 0 (minimum) to 100 (maximum).
+ * @return The value at rank floor(percent / 100 * total), or 0 for an empty histogram.
+ */
+int Histogram::percentile(int channel, double percent) const {
+    uint64_t samples = total(channel);
+    if (samples == 0) {
+        return 0;
+    }
+    double clamped = std::max(0.0, std::min(100.0, percent));
+    uint64_t rank = std::min(static_cast<uint64_t>(clamped / 100.0 * samples), samples - 1);
+    uint64_t seen = 0;
+    for (int v = 0; v < 256; ++v) {
+        seen += count(channel, v);
+        if (seen > rank) {
+            return v;
+        }
+    }
+    return 255;
+}
+
+/**
+ * Finds Otsu's threshold of a channel.
+ *
+ * @param channel The channel.
+ * @return The threshold t for which [0, t) and [t, 255] have the largest between-class variance.
+ */
+int Histogram::otsuThreshold(int channel) const {
+    return otsuThresholds(2, channel)[0];
+}
+
+/**
+ * Finds the multi-level Otsu thresholds of a channel.
+ *
+ * Maximising the between-class variance is the same as maximising the sum over the classes of
+ * (sum of values)^2 / count, so the best split of [0, b) into k classes is the best split of some
+ * [0, a) into k - 1 classes plus the class [a, b). The dynamic programme over k and b takes
+ * O(classes * 256^2) steps, with the class sums read from prefix sums of the bins.
+ *
+ * @param channel The channel.
+ * @param classes The number of classes, clamped to [2, 256].
+ * @return classes - 1 increasing thresholds; class k holds the values from thresholds[k - 1] up to
+ *         thresholds[k] - 1. When several splits are as good, the first one found is kept.
+ */
+std::vector<int> Histogram::otsuThresholds(int classes, int channel) const {
+    classes = std::max(2, std::min(256, classes));
+
+    // Prefix counts and prefix sums of the values
+    std::vector<double> pixels(257, 0.0), sums(257, 0.0);
+    for (int v = 0; v < 256; ++v) {
+        pixels[v + 1] = pixels[v] + count(channel, v);
+        sums[v + 1] = sums[v] + static_cast<double>(count(channel, v)) * v;
+    }
+    auto score = [&](int begin, int end) { // values [begin, end) as one class
+        double n = pixels[end] - pixels[begin];
+        double s = sums[end] - sums[begin];
+        return n > 0.0 ? s * s / n : 0.0;
+    };
+
+    // best[k][b]: best score of [0, b) split into k + 1 non-empty ranges; start[k][b]: where the last begins
+    std::vector<std::vector<double>> best(classes, std::vector<double>(257, -1.0));
+    std::vector<std::vector<int>> start(classes, std::vector<int>(257, 0));
+    for (int b = 1; b <= 256; ++b) {
+        best[0][b] = score(0, b);
+    }
+    for (int k = 1; k < classes; ++k) {
+        for (int b = k + 1; b <= 256; ++b) {
+            for (int a = k; a < b; ++a) {
+                double candidate = best[k - 1][a] + score(a, b);
+                if (candidate > best[k][b]) {
+                    best[k][b] = candidate;
+                    start[k][b] = a;
+                }
+            }
+        }
+    }
+
+    std::vector<int> thresholds(classes - 1);
+    int end = 256;
+    for (int k = classes - 1; k > 0; --k) {
+        end = start[k][end];
+        thresholds[k - 1] = end;
+    }
+    return thresholds;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file Histogram.h
+ *
+ * @brief Declaration of the Histogram class, 256-bin intensity histograms and the statistics
+ *        derived from them.
+ *
+ * A Histogram counts the 8-bit values of every channel of an Image, a Volume or raw interleaved
+ * data in one pass. Mean, variance, minimum, maximum and percentiles are then read from the 256
+ * bins, so no statistic needs a copy of the pixels. Otsu thresholds, which split the values into
+ * classes of the largest between-class variance, are found from the bins in the same way.
+ *
+ * The counting runs on several threads. Each thread fills private bins on their own cache lines
+ * and the bins are summed at the end, so threads never write to shared counters. Every thread
+ * also keeps four copies of its bins and spreads consecutive pixels over them, so long runs of
+ * one value (the background of a scan, say) do not wait on the same counter.
+ *
+ * Usage:
+ *   Histogram histogram(volume);
+ *   double deviation = histogram.standardDeviation();  // channel 0
+ *   int median = histogram.percentile(0, 50.0);
+ *   Histogram luma = Histogram::ofPixels(data, pixelCount, 3, [](const unsigned char* px) {
+ *       return (px[0] + px[1] + px[2]) / 3;            // any per-pixel level in [0, 255]
+ *   });
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "Image.h"
+#include "Parallel.h"
+#include "Volume.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Histogram {
+public:
+    // Histogram of each channel of an image
+    explicit Histogram(const Image& image, int threadCount = 0);
+    // Histogram of each channel of a volume
+    explicit Histogram(const Volume& volume, int threadCount = 0);
+    // Histogram of each channel of pixelCount interleaved pixels
+    Histogram(const unsigned char* data, std::size_t pixelCount, int channels, int threadCount = 0);
+
+    // Single-channel histogram of levelOf(pixel), a value in [0, 255], for every pixel
+    template <typename LevelOf>
+    static Histogram ofPixels(const unsigned char* data, std::size_t pixelCount, int channels, LevelOf&& levelOf,
+                              int threadCount = 0);
+
+    int getChannels() const { return channels; }
+    uint64_t count(int channel, int value) const { return counts[channel * 256 + value]; }
+    uint64_t total(int channel = 0) const;
+
+    // The channels' counts added together, as one channel
+    Histogram merged() const;
+
+    double mean(int channel = 0) const;
+    double variance(int channel = 0) const;
+    double standardDeviation(int channel = 0) const;
+    // Smallest and largest value present (0 for an empty histogram)
+    int minimum(int channel = 0) const;
+    int maximum(int channel = 0) const;
+    // Value at rank floor(percent / 100 * total), clamped to the last rank, in sorted order
+    int percentile(int channel, double percent) const;
+
+    // Otsu's threshold: values below it form one class, the others a second one
+    int otsuThreshold(int channel = 0) const;
+    // classes - 1 increasing Otsu thresholds, each the first value of the next class (2 to 256 classes)
+    std::vector<int> otsuThresholds(int classes, int channel = 0) const;
+
+private:
+    // Pixels counted by each thread at least, so that small images stay on one thread
+    static constexpr std::size_t minimumPixelsPerThread = 64 * 1024;
+    // Copies of the bins per thread
+    static constexpr int binCopies = 4;
+
+    int channels;
+    std::vector<uint64_t> counts; // channels * 256 bins
+
+    explicit Histogram(int channels);
+
+    // Splits [0, pixelCount) over the threads. countRange(begin, end, bins) adds pixels [begin, end)
+    // to a zeroed block of binCopies * channels * 256 private bins; the blocks are then summed.
+    template <typename CountRange>
+    void fill(std::size_t pixelCount, CountRange&& countRange, int threadCount);
+
+    void countChannels(const unsigned char* data, std::size_t pixelCount, int threadCount);
+};
+
+template <typename CountRange>
+void Histogram::fill(std::size_t pixelCount, CountRange&& countRange, int threadCount) {
+    std::size_t binsPerCopy = static_cast<std::size_t>(channels) * 256;
+    std::size_t wanted = pixelCount / minimumPixelsPerThread + 1;
+    int workers = static_cast<int>(std::min<std::size_t>(Parallel::resolveThreadCount(threadCount), wanted));
+
+    // Each block starts on a cache line, so no two threads share one
+    std::vector<std::vector<uint32_t, AlignedAllocator<uint32_t>>> partial(workers);
+    Parallel::parallelFor(0, workers, [&](int w) {
+        partial[w].assign(binCopies * binsPerCopy, 0);
+        std::size_t begin = pixelCount * w / workers;
+        std::size_t end = pixelCount * (w + 1) / workers;
+        countRange(begin, end, partial[w].data());
+    }, workers);
+
+    for (const auto& bins : partial) {
+        for (int copy = 0; copy < binCopies; ++copy) {
+            for (std::size_t b = 0; b < binsPerCopy; ++b) {
+                counts[b] += bins[copy * binsPerCopy + b];
+            }
+        }
+    }
+}
+
+template <typename LevelOf>
+Histogram Histogram::ofPixels(const unsigned char* data, std::size_t pixelCount, int channels, LevelOf&& levelOf,
+                              int threadCount) {
+    Histogram histogram(1);
+    histogram.fill(pixelCount, [&](std::size_t begin, std::size_t end, uint32_t* bins) {
+        std::size_t p = begin;
+        for (; p + binCopies <= end; p += binCopies) {
+            for (int copy = 0; copy < binCopies; ++copy) {
+                bins[copy * 256 + levelOf(data + (p + copy) * channels)]++;
+            }
+        }
+        for (; p < end; ++p) {
+            bins[levelOf(data + p * channels)]++;
+        }
+    }, threadCount);
+    return histogram;
+}
+
+#endif // HISTOGRAM_H
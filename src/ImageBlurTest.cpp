@@ -7,10 +7,22 @@
 #include "ImageBlurTest.h"
 #include "Image.h"
 #include "ImageBlur.h"
+#include "MedianNetwork.h"
 #include "ColourCorrection.h"
+#include "Histogram.h"
+#include "RankFilter.h"
+#include "SummedAreaTable.h"
+#include "ThreeDFilter.h"
+#include "Volume.h"
+#include <algorithm>
 #include <iostream>
-#include <numeric>
 #include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
 
 void ImageBlurTest::run(int testType) {
     ImageBlurTestType specificTestType = static_cast<ImageBlurTestType>(testType);
@@ -24,12 +36,33 @@ void ImageBlurTest::run(int testType) {
         case TestGaussianBlur:
             testGaussianBlur();
             break;
+        case TestAdaptiveMedian:
+            testAdaptiveMedian();
+            break;
+        case TestSummedAreaTable:
+            testSummedAreaTable();
+            break;
+        case TestRankFilter:
+            testRankFilter();
+            break;
+        case TestMedianNetwork:
+            testMedianNetwork();
+            break;
         default:
             std::cerr << "Unknown blur test type provided." << std::endl;
             break;
     }
 }
 
+std::vector<unsigned char> ImageBlurTest::randomPixels(int width, int height, int channels, unsigned int seed) {
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(width) * height * channels);
+    std::mt19937 random(seed);
+    for (unsigned char& pixel : pixels) {
+        pixel = static_cast<unsigned char>(random());
+    }
+    return pixels;
+}
+
 double ImageBlurTest::calculateNoiseLevel(const Image& image) {
     const unsigned char* data = image.getData();
     int width = image.getWidth();
@@ -76,23 +109,7 @@ void ImageBlurTest::testMedianBlur() {
 }
 
 double ImageBlurTest::calculateStdDev(const Image& image) {
-    const unsigned char* data = image.getData();
-    int width = image.getWidth();
-    int height = image.getHeight();
-    int channels = image.getChannels();
-    std::vector<double> pixelValues;
-
-    for (int i = 0; i < width * height * channels; ++i) {
-        pixelValues.push_back(static_cast<double>(data[i]));
-    }
-    double mean = std::accumulate(pixelValues.begin(), pixelValues.end(), 0.0) / pixelValues.size();
-    double varianceSum = 0.0;
-    for (double value : pixelValues) {
-        varianceSum += (value - mean) * (value - mean);
-    }
-    double variance = varianceSum / pixelValues.size();
-
-    return sqrt(variance);
+    return Histogram(image).merged().standardDeviation();
 }
 
 // This function evaluates the box blur effect on an image. It calculates the
@@ -154,4 +171,291 @@ void ImageBlurTest::testGaussianBlur() {
     } else {
         std::cerr << "Gaussian Blur Test Failed: The standard deviation did not decrease significantly." << std::endl;
     }
+}
+
+// This function tests the Adaptive Median filter on vh_anatomy.png with 15% salt and pepper noise
+// added from a fixed seed. The filter only replaces impulse pixels (0 or 255), so the noise level
+// must drop while every byte that was neither 0 nor 255 stays exactly as it was. A flat black image filtered
+// with a window far larger than the image must also stay black (and finish promptly), since every
+// pixel is an impulse candidate whose windows stop growing at the image size.
+void ImageBlurTest::testAdaptiveMedian() {
+    Image image;
+    if (!image.loadImage("../Images/vh_anatomy.png")) {
+        std::cerr << "Failed to load image for adaptive median test." << std::endl;
+        return;
+    }
+    ColourCorrection noise(SaltPepperNoise, 15);
+    noise.setSeed(2024);
+    noise.apply(image);
+
+    std::size_t size = static_cast<std::size_t>(image.getWidth()) * image.getHeight() * image.getChannels();
+    std::vector<unsigned char> original(image.getData(), image.getData() + size);
+    double originalNoiseLevel = calculateNoiseLevel(image);
+
+    ImageBlur adaptiveMedian(AdaptiveMedian, 7);
+    adaptiveMedian.apply(image);
+    double filteredNoiseLevel = calculateNoiseLevel(image);
+
+    bool othersKept = true;
+    for (std::size_t i = 0; i < size && othersKept; ++i) {
+        if (original[i] != 0 && original[i] != 255) {
+            othersKept = image.getData()[i] == original[i];
+        }
+    }
+
+    const int flatSize = 48;
+    unsigned char* black = static_cast<unsigned char*>(std::malloc(flatSize * flatSize));
+    std::memset(black, 0, flatSize * flatSize);
+    Image flat;
+    flat.updateData(black, flatSize, flatSize, 1);
+    ImageBlur(AdaptiveMedian, 100001).apply(flat);
+    bool flatKept = true;
+    for (int i = 0; i < flatSize * flatSize; ++i) {
+        flatKept = flatKept && flat.getData()[i] == 0;
+    }
+
+    if (filteredNoiseLevel < originalNoiseLevel && othersKept && flatKept) {
+        std::cout << "Adaptive Median Test Passed: The input image is vh_anatomy.png with 15% salt and pepper noise, the noise level decreased from "
+                  << originalNoiseLevel << " to " << filteredNoiseLevel << ", and every pixel other than 0 or 255 is unchanged." << std::endl;
+    } else {
+        std::cerr << "Adaptive Median Test Failed:"
+                  << (filteredNoiseLevel < originalNoiseLevel ? "" : " the noise level did not decrease.")
+                  << (othersKept ? "" : " pixels other than 0 or 255 were changed.")
+                  << (flatKept ? "" : " a flat black image did not stay black.") << std::endl;
+    }
+}
+
+// This function tests the summed-area tables against sums taken pixel by pixel. On a random image,
+// sum() and clippedSum() of values and squares must match for random rectangles, single pixels, the
+// whole image and rectangles hanging over every edge. On a white 4200 x 4200 image the value sums
+// pass 2^32: the 32-bit table wraps but must still give exact sums over rectangles of up to 2^32 / 255
+// pixels, and the 64-bit table must give the exact sum over the whole image.
+void ImageBlurTest::testSummedAreaTable() {
+    const int width = 53, height = 41, channels = 3;
+    std::vector<unsigned char> pixels = randomPixels(width, height, channels, 2024);
+    IntegralImage sums(pixels.data(), width, height, channels);
+    IntegralImage64 squares(pixels.data(), width, height, channels, true);
+
+    int mismatches = 0;
+    auto check = [&](int x0, int y0, int x1, int y1) {
+        for (int c = 0; c < channels; ++c) {
+            uint64_t sum = 0, sumSquares = 0;
+            int count = 0;
+            for (int y = std::max(y0, 0); y < std::min(y1, height); ++y) {
+                for (int x = std::max(x0, 0); x < std::min(x1, width); ++x) {
+                    uint64_t value = pixels[(static_cast<std::size_t>(y) * width + x) * channels + c];
+                    sum += value;
+                    sumSquares += value * value;
+                    ++count;
+                }
+            }
+            int clippedCount = -1, squaresCount = -1;
+            mismatches += sums.clippedSum(x0, y0, x1, y1, c, clippedCount) != sum || clippedCount != count;
+            mismatches += squares.clippedSum(x0, y0, x1, y1, c, squaresCount) != sumSquares || squaresCount != count;
+            if (x0 >= 0 && y0 >= 0 && x1 <= width && y1 <= height) {
+                mismatches += sums.sum(x0, y0, x1, y1, c) != sum || squares.sum(x0, y0, x1, y1, c) != sumSquares;
+            }
+        }
+    };
+    std::mt19937 random(2025);
+    for (int i = 0; i < 500; ++i) {
+        int x0 = static_cast<int>(random() % width), y0 = static_cast<int>(random() % height);
+        check(x0, y0, x0 + 1 + static_cast<int>(random() % (width - x0)), y0 + 1 + static_cast<int>(random() % (height - y0)));
+    }
+    check(7, 9, 8, 10);
+    check(0, 0, width, height);
+    check(-5, -3, 10, 12);
+    check(width - 4, height - 6, width + 9, height + 2);
+    check(-100, -100, width + 100, height + 100);
+    check(width + 1, 0, width + 5, height); // entirely outside: an empty sum
+
+    // The 32-bit table wraps past 2^32 but stays exact over rectangles within its limit
+    const int white = 4200;
+    std::vector<unsigned char> bright(static_cast<std::size_t>(white) * white, 255);
+    IntegralImage wrapped(bright.data(), white, white, 1);
+    IntegralImage64 wide(bright.data(), white, white, 1);
+    const uint64_t pixelCount = static_cast<uint64_t>(white) * white;
+    bool overflowExact = wrapped.sum(white - 4000, white - 4000, white, white, 0) == 4000u * 4000u * 255u &&
+                         wrapped.sum(white - 3, white - 2, white, white, 0) == 6u * 255u &&
+                         wide.sum(0, 0, white, white, 0) == pixelCount * 255 && pixelCount * 255 > UINT32_MAX;
+
+    if (mismatches == 0 && overflowExact) {
+        std::cout << "Summed-Area Table Test Passed: Value and square sums of a random 53x41 image match direct sums over "
+                  << "every tested rectangle, and sums past 2^32 on a white 4200x4200 image are exact." << std::endl;
+    } else {
+        std::cerr << "Summed-Area Table Test Failed: " << mismatches << " rectangle sums differ from direct sums"
+                  << (overflowExact ? "." : ", and sums past 2^32 are not exact.") << std::endl;
+    }
+}
+
+// This function tests the rank filters against sorting every window. On a random image, the
+// minimum, maximum, median and other percentiles of the in-bounds pixels of each window must be
+// the value at floor(percentile / 100 * count) of the sorted window, for kernels filtered with
+// Huang's algorithm (up to 23) and with Perreault-Hebert (above), windows that shrink at the
+// edges, and a kernel taller than the image. The Image helpers minimum() and maximum() must agree.
+void ImageBlurTest::testRankFilter() {
+    const int width = 61, height = 47, channels = 3;
+    std::vector<unsigned char> pixels = randomPixels(width, height, channels, 2024);
+    std::vector<unsigned char> output(pixels.size()), expected(pixels.size()), window;
+
+    auto sortedRank = [&](int kernelSize, double percentile) {
+        int half = kernelSize / 2;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                for (int c = 0; c < channels; ++c) {
+                    window.clear();
+                    for (int wy = std::max(y - half, 0); wy <= std::min(y + half, height - 1); ++wy) {
+                        for (int wx = std::max(x - half, 0); wx <= std::min(x + half, width - 1); ++wx) {
+                            window.push_back(pixels[(static_cast<std::size_t>(wy) * width + wx) * channels + c]);
+                        }
+                    }
+                    std::size_t rank = std::min(static_cast<std::size_t>(std::floor(percentile / 100.0 * window.size())),
+                                                window.size() - 1);
+                    std::nth_element(window.begin(), window.begin() + rank, window.end());
+                    expected[(static_cast<std::size_t>(y) * width + x) * channels + c] = window[rank];
+                }
+            }
+        }
+    };
+
+    const int kernelSizes[] = { 1, 3, 7, 23, 25, 51 };
+    const double percentiles[] = { 0.0, 12.5, 50.0, 90.0, 100.0 };
+    int failures = 0;
+    for (int kernelSize : kernelSizes) {
+        for (double percentile : percentiles) {
+            RankFilter::apply(pixels.data(), output.data(), width, height, channels, kernelSize, percentile, 3);
+            sortedRank(kernelSize, percentile);
+            failures += output != expected;
+        }
+    }
+
+    Image image;
+    unsigned char* copy = static_cast<unsigned char*>(std::malloc(pixels.size()));
+    std::memcpy(copy, pixels.data(), pixels.size());
+    image.updateData(copy, width, height, channels);
+    RankFilter::minimum(image, 5);
+    sortedRank(5, 0.0);
+    failures += !std::equal(expected.begin(), expected.end(), image.getData());
+    std::memcpy(image.getData(), pixels.data(), pixels.size());
+    RankFilter::maximum(image, 5);
+    sortedRank(5, 100.0);
+    failures += !std::equal(expected.begin(), expected.end(), image.getData());
+
+    if (failures == 0) {
+        std::cout << "Rank Filter Test Passed: Minimum, maximum and percentile filters of a random 61x47 image match "
+                  << "sorted windows for kernels from 1 to 51." << std::endl;
+    } else {
+        std::cerr << "Rank Filter Test Failed: " << failures << " kernel and percentile combinations differ from sorted windows." << std::endl;
+    }
+}
+
+// This function tests the median networks against std::nth_element. The 9-, 25- and 27-value
+// networks must select the median of random values and of values with many ties, and medianRun()
+// must filter runs of every length around the 16- and 32-byte vector widths. The blurs that choose
+// a network on their own (3x3 and 5x5 median blur, 3x3x3 volume median) must then match medians
+// of the in-bounds 2D windows and of the edge-clamped 3D windows of random data.
+void ImageBlurTest::testMedianNetwork() {
+    int failures = 0;
+    std::mt19937 random(2024);
+    auto checkSelect = [&](auto size, int range) {
+        constexpr int N = decltype(size)::value;
+        unsigned char values[N], sorted[N];
+        for (int trial = 0; trial < 2000; ++trial) {
+            for (int t = 0; t < N; ++t) {
+                values[t] = sorted[t] = static_cast<unsigned char>(random() % range);
+            }
+            std::nth_element(sorted, sorted + N / 2, sorted + N);
+            failures += MedianNetwork<N>::select(values) != sorted[N / 2];
+        }
+    };
+    auto checkRun = [&](auto size) {
+        constexpr int N = decltype(size)::value;
+        std::ptrdiff_t offsets[N];
+        for (int t = 0; t < N; ++t) {
+            offsets[t] = t * 7;
+        }
+        std::vector<unsigned char> source = randomPixels(80 + 7 * N, 1, 1, 2025), out(80);
+        for (std::size_t count : { 1, 15, 16, 17, 31, 32, 33, 63, 80 }) {
+            MedianNetwork<N>::medianRun(source.data(), offsets, out.data(), count);
+            for (std::size_t i = 0; i < count; ++i) {
+                unsigned char values[N];
+                for (int t = 0; t < N; ++t) {
+                    values[t] = source[i + offsets[t]];
+                }
+                std::nth_element(values, values + N / 2, values + N);
+                failures += out[i] != values[N / 2];
+            }
+        }
+    };
+    checkSelect(std::integral_constant<int, 9>(), 256);
+    checkSelect(std::integral_constant<int, 9>(), 3);
+    checkSelect(std::integral_constant<int, 25>(), 256);
+    checkSelect(std::integral_constant<int, 25>(), 3);
+    checkSelect(std::integral_constant<int, 27>(), 256);
+    checkSelect(std::integral_constant<int, 27>(), 3);
+    checkRun(std::integral_constant<int, 9>());
+    checkRun(std::integral_constant<int, 25>());
+    checkRun(std::integral_constant<int, 27>());
+
+    // 3x3 and 5x5 median blurs pick the networks; edge windows shrink and take the upper middle value
+    const int width = 45, height = 29, channels = 3;
+    std::vector<unsigned char> pixels = randomPixels(width, height, channels, 2026);
+    for (int kernelSize : { 3, 5 }) {
+        Image image;
+        unsigned char* copy = static_cast<unsigned char*>(std::malloc(pixels.size()));
+        std::memcpy(copy, pixels.data(), pixels.size());
+        image.updateData(copy, width, height, channels);
+        ImageBlur(Median, kernelSize).apply(image);
+        int half = kernelSize / 2;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                for (int c = 0; c < channels; ++c) {
+                    std::vector<unsigned char> window;
+                    for (int wy = std::max(y - half, 0); wy <= std::min(y + half, height - 1); ++wy) {
+                        for (int wx = std::max(x - half, 0); wx <= std::min(x + half, width - 1); ++wx) {
+                            window.push_back(pixels[(static_cast<std::size_t>(wy) * width + wx) * channels + c]);
+                        }
+                    }
+                    std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+                    failures += image.getData()[(static_cast<std::size_t>(y) * width + x) * channels + c] != window[window.size() / 2];
+                }
+            }
+        }
+    }
+
+    // The 3x3x3 volume median picks MedianNetwork<27>; face voxels clamp their neighbours to the edge
+    const int volumeWidth = 37, volumeHeight = 9, depth = 6, volumeChannels = 2;
+    Volume volume(volumeWidth, volumeHeight, depth, volumeChannels);
+    std::vector<unsigned char> voxels = randomPixels(volumeWidth * volumeHeight, depth, volumeChannels, 2027);
+    std::copy(voxels.begin(), voxels.end(), volume.getData());
+    ThreeDFilter::medianBlur(volume, 3, 2);
+    for (int z = 0; z < depth; ++z) {
+        for (int y = 0; y < volumeHeight; ++y) {
+            for (int x = 0; x < volumeWidth; ++x) {
+                for (int c = 0; c < volumeChannels; ++c) {
+                    unsigned char values[27];
+                    int t = 0;
+                    for (int kz = -1; kz <= 1; ++kz) {
+                        for (int ky = -1; ky <= 1; ++ky) {
+                            for (int kx = -1; kx <= 1; ++kx) {
+                                int nx = std::min(std::max(x + kx, 0), volumeWidth - 1);
+                                int ny = std::min(std::max(y + ky, 0), volumeHeight - 1);
+                                int nz = std::min(std::max(z + kz, 0), depth - 1);
+                                values[t++] = voxels[((static_cast<std::size_t>(nz) * volumeHeight + ny) * volumeWidth + nx) * volumeChannels + c];
+                            }
+                        }
+                    }
+                    std::nth_element(values, values + 13, values + 27);
+                    failures += volume.getData()[volume.index(x, y, z, c)] != values[13];
+                }
+            }
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "Median Network Test Passed: The 9-, 25- and 27-value networks, and the 3x3, 5x5 and 3x3x3 "
+                  << "median blurs that use them, match std::nth_element." << std::endl;
+    } else {
+        std::cerr << "Median Network Test Failed: " << failures << " medians differ from std::nth_element." << std::endl;
+    }
 }
\ No newline at end of file
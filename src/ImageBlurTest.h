@@ -9,12 +9,17 @@
 
 #include "Test.h"
 #include "Image.h"
+#include <vector>
 
 // Enum defining the types of blur tests that can be run.
 enum ImageBlurTestType {
     TestMedianBlur, // Test for Median Blur.
     TestBoxBlur, // Test for Box Blur.
-    TestGaussianBlur // Test for Gaussian Blur.
+    TestGaussianBlur, // Test for Gaussian Blur.
+    TestAdaptiveMedian, // Test for Adaptive Median filtering.
+    TestSummedAreaTable, // Test for summed-area table rectangle sums.
+    TestRankFilter, // Test for minimum, maximum and percentile rank filters.
+    TestMedianNetwork // Test for the 3x3, 5x5 and 3x3x3 median networks.
 };
 
 class ImageBlurTest : public Test {
@@ -26,6 +31,11 @@ private:
     void testMedianBlur(); // Tests the Median Blur method.
     void testBoxBlur(); // Tests the Box Blur method.
     void testGaussianBlur(); // Tests the Gaussian Blur method.
+    void testAdaptiveMedian(); // Tests the Adaptive Median filter.
+    void testSummedAreaTable(); // Tests summed-area table rectangle sums against direct sums.
+    void testRankFilter(); // Tests rank filters against sorted windows.
+    void testMedianNetwork(); // Tests the median networks and the blurs that use them against nth_element.
+    static std::vector<unsigned char> randomPixels(int width, int height, int channels, unsigned int seed); // Random bytes from a fixed seed.
     double calculateStdDev(const Image& image); // Calculates standard deviation of the image.
     double calculateNoiseLevel(const Image& image); // Calculates noise level in the image.
 };
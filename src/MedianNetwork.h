@@ -0,0 +1,138 @@
+/**
+ * @file MedianNetwork.h
+ *
+ * @brief Branchless median selection networks for small fixed-size windows.
+ *
+ * MedianNetwork<N> finds the median of N values (N odd) with a fixed sequence of min/max
+ * compare-exchanges, so the same code runs on scalars and on SIMD vectors, where every lane is
+ * an independent window. medianRun() uses this to filter 16 (SSE2) or 32 (AVX2) neighbouring
+ * pixels at once.
+ *
+ * N = 9 uses Paeth's 19-exchange network. Other sizes use forgetful selection: starting from
+ * N / 2 + 2 values, the minimum and maximum of the working set cannot be the median, so both
+ * are dropped and the next input takes their place; when the inputs run out the three values
+ * left hold the median in the middle.
+ *
+ * Usage:
+ *   std::ptrdiff_t offsets[9] = { ... };                    // offsets of the window's pixels
+ *   MedianNetwork<9>::medianRun(source, offsets, out, count); // out[i] = median of source[i + offsets[t]]
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef MEDIANNETWORK_H
+#define MEDIANNETWORK_H
+
+#include "SimdOps.h"
+#include <cstddef>
+#include <utility>
+
+template <int N>
+class MedianNetwork {
+    static_assert(N % 2 == 1 && N >= 3, "MedianNetwork needs an odd number of values");
+
+public:
+    // Returns the median of v[0..N); the contents of v are reordered.
+    template <typename V>
+    static V select(V* v) {
+        return forget<0, N / 2 + 2, N / 2 + 2>(v);
+    }
+
+    // out[i] = median of source[i + offsets[t]] over t in [0, N), for i in [0, count).
+    static void medianRun(const unsigned char* source, const std::ptrdiff_t* offsets, unsigned char* out,
+                          std::size_t count) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= count; i += 32) {
+            __m256i v[N];
+            for (int t = 0; t < N; ++t) {
+                v[t] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + offsets[t]));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), select(v));
+        }
+#endif
+#if defined(SIMDOPS_SSE2)
+        for (; i + 16 <= count; i += 16) {
+            __m128i v[N];
+            for (int t = 0; t < N; ++t) {
+                v[t] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + offsets[t]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), select(v));
+        }
+#endif
+        for (; i < count; ++i) {
+            unsigned char v[N];
+            for (int t = 0; t < N; ++t) {
+                v[t] = source[i + offsets[t]];
+            }
+            out[i] = select(v);
+        }
+    }
+
+private:
+    static unsigned char lower(unsigned char a, unsigned char b) { return a < b ? a : b; }
+    static unsigned char upper(unsigned char a, unsigned char b) { return a < b ? b : a; }
+#if defined(SIMDOPS_SSE2)
+    static __m128i lower(__m128i a, __m128i b) { return _mm_min_epu8(a, b); }
+    static __m128i upper(__m128i a, __m128i b) { return _mm_max_epu8(a, b); }
+#endif
+#if defined(__AVX2__)
+    static __m256i lower(__m256i a, __m256i b) { return _mm256_min_epu8(a, b); }
+    static __m256i upper(__m256i a, __m256i b) { return _mm256_max_epu8(a, b); }
+#endif
+
+    // Orders a pair so that a <= b
+    template <typename V>
+    static void exchange(V& a, V& b) {
+        V low = lower(a, b);
+        b = upper(a, b);
+        a = low;
+    }
+
+    // Forgetful selection on the working set v[Lo..Hi), with inputs v[Next..N) still to come.
+    // The recursion is resolved at compile time, so every exchange is unrolled.
+    template <int Lo, int Hi, int Next, typename V>
+    static V forget(V* v) {
+        if constexpr (Next < N) {
+            placeMinimum<Lo>(v, std::make_integer_sequence<int, Hi - Lo - 1>());
+            placeMaximum<Lo, Hi>(v, std::make_integer_sequence<int, Hi - Lo - 2>());
+            // Forget the minimum and replace the maximum with the next input
+            v[Hi - 1] = v[Next];
+            return forget<Lo + 1, Hi, Next + 1>(v);
+        } else {
+            exchange(v[Lo], v[Lo + 1]);
+            exchange(v[Lo + 1], v[Lo + 2]);
+            return upper(v[Lo], v[Lo + 1]);
+        }
+    }
+
+    // Moves the minimum of v[Lo..Lo + 1 + sizeof...(I)) to v[Lo]
+    template <int Lo, typename V, int... I>
+    static void placeMinimum(V* v, std::integer_sequence<int, I...>) {
+        (exchange(v[Lo], v[Lo + 1 + I]), ...);
+    }
+
+    // Moves the maximum of v[Lo + 1..Hi) to v[Hi - 1]
+    template <int Lo, int Hi, typename V, int... I>
+    static void placeMaximum(V* v, std::integer_sequence<int, I...>) {
+        (exchange(v[Lo + 1 + I], v[Hi - 1]), ...);
+    }
+};
+
+// Paeth's 3 x 3 median network: 19 compare-exchanges
+template <>
+template <typename V>
+V MedianNetwork<9>::select(V* p) {
+    exchange(p[1], p[2]); exchange(p[4], p[5]); exchange(p[7], p[8]);
+    exchange(p[0], p[1]); exchange(p[3], p[4]); exchange(p[6], p[7]);
+    exchange(p[1], p[2]); exchange(p[4], p[5]); exchange(p[7], p[8]);
+    exchange(p[0], p[3]); exchange(p[5], p[8]); exchange(p[4], p[7]);
+    exchange(p[3], p[6]); exchange(p[1], p[4]); exchange(p[2], p[5]);
+    exchange(p[4], p[7]); exchange(p[4], p[2]); exchange(p[6], p[4]);
+    exchange(p[4], p[2]);
+    return p[4];
+}
+
+#endif // MEDIANNETWORK_H
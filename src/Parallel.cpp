@@ -0,0 +1,47 @@
+/**
+ * @file Parallel.cpp
+ *
+ * @brief Thread count configuration for the Parallel worker helpers.
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+#include "Parallel.h"
+
+namespace {
+    std::atomic<int> defaultThreadCount(0);
+}
+
+/**
+ * Sets the default number of worker threads used when a call does not ask for a count.
+ *
+ * @param count The number of threads; 0 or less restores the hardware concurrency.
+ */
+void Parallel::setThreadCount(int count) {
+    defaultThreadCount.store(std::max(count, 0));
+}
+
+/**
+ * Gets the default number of worker threads.
+ *
+ * @return The configured thread count, or the hardware concurrency if none was set.
+ */
+int Parallel::getThreadCount() {
+    int count = defaultThreadCount.load();
+    if (count > 0) {
+        return count;
+    }
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? static_cast<int>(hardware) : 1;
+}
+
+/**
+ * Resolves the thread count for a single call.
+ *
+ * @param requested The count asked for by the caller; 0 or less means "use the default".
+ * @return The number of threads to use, at least 1.
+ */
+int Parallel::resolveThreadCount(int requested) {
+    return requested > 0 ? requested : getThreadCount();
+}
@@ -0,0 +1,103 @@
+/**
+ * @file Parallel.h
+ *
+ * @brief Minimal worker pool helpers shared by the volume and image filters.
+ *
+ * Parallel::parallelFor runs a loop body over an index range on a group of worker threads.
+ * Indices are claimed from a shared atomic counter, so faster threads pick up the remaining
+ * work of slower ones. Every index is processed exactly once by exactly one thread, so a body
+ * that only writes the output belonging to its own index gives the same result for any
+ * thread count.
+ *
+ * The default number of threads is the hardware concurrency and can be overridden globally
+ * with Parallel::setThreadCount or per call.
+ *
+ * Usage:
+ *   Parallel::parallelFor(0, depth, [&](int z) {
+ *       // process slice z
+ *   });
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+class Parallel {
+public:
+    // Sets the default number of worker threads (0 restores the hardware concurrency).
+    static void setThreadCount(int count);
+
+    // Gets the default number of worker threads.
+    static int getThreadCount();
+
+    // Resolves a per-call thread count: values <= 0 fall back to the default.
+    static int resolveThreadCount(int requested);
+
+    // Calls body(i) for every i in [begin, end) using up to threadCount threads.
+    // The calling thread takes part in the work. Exceptions thrown by the body are
+    // rethrown on the calling thread once every worker has finished.
+    template <typename Body>
+    static void parallelFor(int begin, int end, Body&& body, int threadCount = 0) {
+        if (end <= begin) {
+            return;
+        }
+        int workers = std::min(resolveThreadCount(threadCount), end - begin);
+        if (workers <= 1) {
+            for (int i = begin; i < end; ++i) {
+                body(i);
+            }
+            return;
+        }
+
+        std::atomic<int> next(begin);
+        std::exception_ptr failure;
+        std::atomic<bool> failed(false);
+        auto worker = [&]() {
+            try {
+                for (int i = next.fetch_add(1); i < end && !failed.load(); i = next.fetch_add(1)) {
+                    body(i);
+                }
+            } catch (...) {
+                if (!failed.exchange(true)) {
+                    failure = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (int t = 1; t < workers; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // Calls body(offset, length) for consecutive chunks of chunkSize elements covering
+    // [0, total); the last chunk may be shorter. Chunks are distributed like parallelFor.
+    template <typename Body>
+    static void parallelForChunks(std::size_t total, std::size_t chunkSize, Body&& body, int threadCount = 0) {
+        int chunkCount = static_cast<int>((total + chunkSize - 1) / chunkSize);
+        parallelFor(0, chunkCount, [&](int chunk) {
+            std::size_t offset = static_cast<std::size_t>(chunk) * chunkSize;
+            body(offset, std::min(chunkSize, total - offset));
+        }, threadCount);
+    }
+};
+
+#endif // PARALLEL_H
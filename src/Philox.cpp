@@ -0,0 +1,185 @@
+/**
+ * @file Philox.cpp
+ *
+ * @brief Implementation of the Philox4x32-10 counter-based random number generator.
+ *
+ * Block n of stream s uses the counter (low 32 bits of n, high 32 bits of n, s, 0) and the seed
+ * as the key. The vector paths keep one block per lane, four (SSE2) or eight (AVX2) at a time,
+ * and transpose the results back to four consecutive words per block, so they produce exactly the
+ * words of the scalar path.
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#include "Philox.h"
+#include "SimdOps.h"
+#include <chrono>
+#include <random>
+
+// Round multipliers and Weyl key increments of Philox4x32
+static const uint32_t philoxM0 = 0xD2511F53u;
+static const uint32_t philoxM1 = 0xCD9E8D57u;
+static const uint32_t philoxW0 = 0x9E3779B9u;
+static const uint32_t philoxW1 = 0xBB67AE85u;
+static const int philoxRounds = 10;
+
+/**
+ * Constructor: Creates a generator.
+ *
+ * @param seed The key; generators with the same seed produce the same blocks.
+ */
+Philox::Philox(uint64_t seed) {
+    key[0] = static_cast<uint32_t>(seed);
+    key[1] = static_cast<uint32_t>(seed >> 32);
+}
+
+/**
+ * Generates one block.
+ *
+ * @param block The block number within the stream.
+ * @param stream The stream number.
+ * @return The four random words of the block.
+ */
+std::array<uint32_t, 4> Philox::block(uint64_t block, uint32_t stream) const {
+    uint32_t c0 = static_cast<uint32_t>(block), c1 = static_cast<uint32_t>(block >> 32), c2 = stream, c3 = 0;
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < philoxRounds; ++round) {
+        uint64_t product0 = static_cast<uint64_t>(philoxM0) * c0;
+        uint64_t product1 = static_cast<uint64_t>(philoxM1) * c2;
+        uint32_t n0 = static_cast<uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(product1);
+        c3 = static_cast<uint32_t>(product0);
+        c0 = n0;
+        c2 = n2;
+        k0 += philoxW0;
+        k1 += philoxW1;
+    }
+    return {c0, c1, c2, c3};
+}
+
+#if defined(__AVX2__)
+// High and low halves of the 32 x 32-bit products of the lanes of a with m
+static inline void mulHiLo(__m256i a, __m256i m, __m256i& hi, __m256i& lo) {
+    __m256i even = _mm256_shuffle_epi32(_mm256_mul_epu32(a, m), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i odd = _mm256_shuffle_epi32(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), m), _MM_SHUFFLE(3, 1, 2, 0));
+    lo = _mm256_unpacklo_epi32(even, odd);
+    hi = _mm256_unpackhi_epi32(even, odd);
+}
+#endif
+
+#if defined(SIMDOPS_SSE2)
+// High and low halves of the 32 x 32-bit products of the lanes of a with m
+static inline void mulHiLo(__m128i a, __m128i m, __m128i& hi, __m128i& lo) {
+    // Products of lanes 0 and 2, and of lanes 1 and 3, reordered to (low, low, high, high)
+    __m128i even = _mm_shuffle_epi32(_mm_mul_epu32(a, m), _MM_SHUFFLE(3, 1, 2, 0));
+    __m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(a, 32), m), _MM_SHUFFLE(3, 1, 2, 0));
+    lo = _mm_unpacklo_epi32(even, odd);
+    hi = _mm_unpackhi_epi32(even, odd);
+}
+#endif
+
+/**
+ * Generates consecutive blocks of a stream.
+ *
+ * @param words The output, 4 * count words; block first + b goes to words[4 * b] to words[4 * b + 3].
+ * @param first The first block number.
+ * @param count The number of blocks.
+ * @param stream The stream number.
+ */
+void Philox::fill(uint32_t* words, uint64_t first, std::size_t count, uint32_t stream) const {
+    std::size_t b = 0;
+#if defined(__AVX2__)
+    for (; b + 8 <= count; b += 8) {
+        alignas(32) uint32_t low[8], high[8];
+        for (int lane = 0; lane < 8; ++lane) {
+            uint64_t n = first + b + lane;
+            low[lane] = static_cast<uint32_t>(n);
+            high[lane] = static_cast<uint32_t>(n >> 32);
+        }
+        __m256i c0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(low));
+        __m256i c1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(high));
+        __m256i c2 = _mm256_set1_epi32(static_cast<int>(stream));
+        __m256i c3 = _mm256_setzero_si256();
+        __m256i m0 = _mm256_set1_epi32(static_cast<int>(philoxM0));
+        __m256i m1 = _mm256_set1_epi32(static_cast<int>(philoxM1));
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < philoxRounds; ++round) {
+            __m256i hi0, lo0, hi1, lo1;
+            mulHiLo(c0, m0, hi0, lo0);
+            mulHiLo(c2, m1, hi1, lo1);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(k0)));
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(k1)));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += philoxW0;
+            k1 += philoxW1;
+        }
+        // Transpose within each 128-bit half, then write the halves' blocks in order
+        __m256i t0 = _mm256_unpacklo_epi32(c0, c1), t1 = _mm256_unpacklo_epi32(c2, c3);
+        __m256i t2 = _mm256_unpackhi_epi32(c0, c1), t3 = _mm256_unpackhi_epi32(c2, c3);
+        __m256i r0 = _mm256_unpacklo_epi64(t0, t1), r1 = _mm256_unpackhi_epi64(t0, t1);
+        __m256i r2 = _mm256_unpacklo_epi64(t2, t3), r3 = _mm256_unpackhi_epi64(t2, t3);
+        __m256i* out = reinterpret_cast<__m256i*>(words + 4 * b);
+        _mm256_storeu_si256(out, _mm256_permute2x128_si256(r0, r1, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(r2, r3, 0x20));
+        _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(r0, r1, 0x31));
+        _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(r2, r3, 0x31));
+    }
+#endif
+#if defined(SIMDOPS_SSE2)
+    for (; b + 4 <= count; b += 4) {
+        alignas(16) uint32_t low[4], high[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t n = first + b + lane;
+            low[lane] = static_cast<uint32_t>(n);
+            high[lane] = static_cast<uint32_t>(n >> 32);
+        }
+        __m128i c0 = _mm_load_si128(reinterpret_cast<const __m128i*>(low));
+        __m128i c1 = _mm_load_si128(reinterpret_cast<const __m128i*>(high));
+        __m128i c2 = _mm_set1_epi32(static_cast<int>(stream));
+        __m128i c3 = _mm_setzero_si128();
+        __m128i m0 = _mm_set1_epi32(static_cast<int>(philoxM0));
+        __m128i m1 = _mm_set1_epi32(static_cast<int>(philoxM1));
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < philoxRounds; ++round) {
+            __m128i hi0, lo0, hi1, lo1;
+            mulHiLo(c0, m0, hi0, lo0);
+            mulHiLo(c2, m1, hi1, lo1);
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(static_cast<int>(k0)));
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(static_cast<int>(k1)));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += philoxW0;
+            k1 += philoxW1;
+        }
+        // Lane l of c0..c3 holds block b + l; transpose to four words per block
+        __m128i t0 = _mm_unpacklo_epi32(c0, c1), t1 = _mm_unpacklo_epi32(c2, c3);
+        __m128i t2 = _mm_unpackhi_epi32(c0, c1), t3 = _mm_unpackhi_epi32(c2, c3);
+        __m128i* out = reinterpret_cast<__m128i*>(words + 4 * b);
+        _mm_storeu_si128(out, _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi64(t2, t3));
+    }
+#endif
+    for (; b < count; ++b) {
+        std::array<uint32_t, 4> words4 = block(first + b, stream);
+        for (int w = 0; w < 4; ++w) {
+            words[4 * b + w] = words4[w];
+        }
+    }
+}
+
+/**
+ * Draws a seed from the system's entropy source and the clock.
+ *
+ * @return A 64-bit seed.
+ */
+uint64_t Philox::randomSeed() {
+    std::random_device device;
+    uint64_t entropy = (static_cast<uint64_t>(device()) << 32) | device();
+    return entropy ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
@@ -0,0 +1,70 @@
+/**
+ * @file PointOperation.h
+ *
+ * @brief Declaration of the PointOperation class, a Filter for per-pixel tone mappings.
+ *
+ * A point operation maps every pixel value to a new value independently of its neighbours, so
+ * it is fully described by a 256-entry lookup table. Brightness offsets, thresholds, gamma
+ * correction, inversion and contrast stretching are all built as tables, and a chain of them is
+ * composed into a single table, so applying N operations costs one in-place pass over the image
+ * instead of one pass, allocation and copy per operation.
+ *
+ * Usage:
+ *   PointOperation chain = PointOperation::contrastStretch(20, 235)
+ *                              .then(PointOperation::gamma(0.8))
+ *                              .then(PointOperation::invert());
+ *   chain.apply(image); // colour channels are mapped, alpha is kept
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef POINTOPERATION_H
+#define POINTOPERATION_H
+
+#include "Filter.h"
+#include "Image.h"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class PointOperation : public Filter {
+public:
+    // The identity mapping
+    PointOperation();
+    // An arbitrary mapping given as a 256-entry table
+    explicit PointOperation(const unsigned char* table);
+
+    // value + offset, clamped to [0, 255]
+    static PointOperation brightness(int offset);
+    // 0 below the threshold, 255 from the threshold up
+    static PointOperation threshold(int threshold);
+    // 255 * (value / 255)^gamma, rounded
+    static PointOperation gamma(double gamma);
+    // 255 - value
+    static PointOperation invert();
+    // Maps [low, high] linearly onto [0, 255], rounded, and clamps values outside it
+    static PointOperation contrastStretch(int low, int high);
+    // Class k of the n classes split by increasing thresholds maps to round(k * 255 / (n - 1))
+    static PointOperation levels(const std::vector<int>& thresholds);
+
+    // The operation that applies this one and then next
+    PointOperation then(const PointOperation& next) const;
+
+    unsigned char operator()(unsigned char value) const { return table[value]; }
+    const unsigned char* getTable() const { return table.data(); }
+
+    // Maps the colour channels in place; the alpha channel of 2- and 4-channel images is kept.
+    void apply(Image& image) override;
+
+    // Maps length bytes of interleaved pixel data in place. When keepAlpha is set and channels is
+    // 2 or 4, the last channel of every pixel is left unchanged.
+    void map(unsigned char* data, std::size_t length, int channels = 1, bool keepAlpha = false,
+             int threadCount = 0) const;
+
+private:
+    std::array<unsigned char, 256> table;
+};
+
+#endif // POINTOPERATION_H
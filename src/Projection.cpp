@@ -6,27 +6,388 @@
  * This file provides the implementation for several projection techniques to visualize 3D volume data in 2D.
  * It supports Maximum Intensity Projection (MIP), Minimum Intensity Projection (MinIP), and Average Intensity
  * Projection (AIP). These methods project the highest, lowest, and average intensity values, respectively, across
- * a specified range of slices from the volume onto a 2D plane.
+ * a specified range of slices from the volume onto a 2D plane. computeProjections can also produce the standard
+ * deviation along z and a MIP depth map, and fills any combination of outputs in one pass over the volume.
  *
  * The output projections are saved as PNG files using the stb_image_write library. This allows for easy visualization
  * and analysis of the volume data.
  *
+ * All projections sweep the volume slice by slice (z outermost). Each slice is read linearly and folded into an
+ * accumulator row with the SIMD kernels from SimdOps.h, and every channel of the interleaved data is projected.
+ * The slice area is cut into chunks that are processed on worker threads, each chunk small enough for its
+ * accumulators to stay in cache while all slices stream past.
+ *
+ * If the volume carries a SlabIndex, MIP, MinIP and AIP of any slab are answered from the index instead,
+ * which costs O(log depth) (MIP, MinIP) or O(1) (AIP) per pixel however thick the slab is. projectSlabSeries
+ * produces a whole series of equally thick slabs in one sweep and hands each image over as soon as it is done.
+ *
  * Dependencies:
  *   - Projection.h for the declaration of the Projection class.
  *   - stb_image_write.h for writing the projection images as PNG files.
  *   - Volume.h for accessing the volume data.
- *   - Standard libraries: <vector>, <numeric>, <limits>, and <algorithm>.
+ *   - SimdOps.h for the vectorised max, min and sum row kernels.
+ *   - SlabIndex.h for answering slab MIP, MinIP and AIP queries from a precomputed index.
+ *   - Parallel.h for processing chunks of the projection on worker threads.
+ *   - Standard libraries: <vector>, <cstdint>, <cmath>, <cstring>, <limits>, <utility>, and <algorithm>.
  * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
  *         edsml-hs1623, acse-xg1123, edsml-st2923,
  *         Group: selection sort.
  */
 #include "Projection.h"
+#include "SimdOps.h"
+#include "SlabIndex.h"
+#include "Parallel.h"
 #include "stb_image_write.h"
 #include <vector>
-#include <numeric> // For std::accumulate
+#include <cstdint>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <utility>
 #include <algorithm>
 
+// Bytes of one slice handled by one task. Small enough that the 32-bit AIP accumulators of a chunk
+// (4x this size) stay in L2 while every slice of the range streams through.
+static const std::size_t projectionChunkBytes = 16 * 1024;
+
+// Bytes of finished slabs that projectSlabSeries holds before emitting them.
+static const std::size_t slabSeriesBufferBytes = 64 * 1024 * 1024;
+
+/**
+ * @brief Converts a 1-based inclusive slice range to 0-based indices clamped to the volume.
+ *
+ * @param volume The volume the range refers to.
+ * @param minZ The first slice (1-based); replaced by the first 0-based index.
+ * @param maxZ The last slice (1-based); replaced by the last 0-based index.
+ * @return True if the clamped range contains at least one slice.
+ */
+bool Projection::resolveRange(const Volume& volume, int& minZ, int& maxZ) {
+    minZ = std::max(minZ - 1, 0); // Ensure not below 0
+    maxZ = std::min(maxZ - 1, volume.getDepth() - 1); // Ensure not beyond the last index
+    return minZ <= maxZ;
+}
+
+/**
+ * @brief Saves one projection image as a PNG file.
+ *
+ * @param outputPath The filesystem path of the PNG file.
+ * @param width The width of the projection.
+ * @param height The height of the projection.
+ * @param channels The number of interleaved channels.
+ * @param projection The interleaved projection pixels.
+ */
+void Projection::writeProjection(const std::string& outputPath, int width, int height, int channels, const std::vector<unsigned char>& projection) {
+    stbi_write_png(outputPath.c_str(), width, height, channels, projection.data(), width * channels);
+}
+
+/**
+ * @brief Computes several projections of a range of slices in a single pass over the voxels.
+ *
+ * Every chunk of the slice area keeps one accumulator row per requested statistic and folds
+ * each slice of the range into all of them before moving on, so the volume is read once no
+ * matter how many outputs are requested. Sums of squares are kept in 32-bit accumulators and
+ * flushed into 64-bit totals before they can overflow.
+ *
+ * When the volume has a SlabIndex that covers every requested output, the projections are
+ * read from the index without touching the voxels of the slab.
+ *
+ * @param volume The 3D volume to project.
+ * @param outputs A mask of ProjectionOutput values selecting the projections to compute.
+ * @param minZ The starting slice index (1-based) of the projection range.
+ * @param maxZ The ending slice index (1-based, inclusive) of the projection range.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return The requested projections. For an empty range MIP, AIP and the standard deviation
+ *         are zero, MinIP is 255 and the depth map holds the first slice of the range.
+ */
+ProjectionSet Projection::computeProjections(const Volume& volume, int outputs, int minZ, int maxZ, int threadCount) {
+    ProjectionSet result;
+    result.width = volume.getWidth();
+    result.height = volume.getHeight();
+    result.channels = volume.getChannels();
+    bool hasRange = resolveRange(volume, minZ, maxZ);
+    result.minZ = minZ;
+    result.maxZ = maxZ;
+
+    std::size_t sliceBytes = volume.getZStride();
+    bool wantMip = outputs & MipOutput, wantMinip = outputs & MinipOutput, wantAip = outputs & AipOutput;
+    bool wantStdDev = outputs & StdDevOutput, wantDepth = outputs & MipDepthOutput;
+    if (wantMip) result.mip.assign(sliceBytes, 0);
+    if (wantMinip) result.minip.assign(sliceBytes, std::numeric_limits<unsigned char>::max());
+    if (wantAip) result.aip.assign(sliceBytes, 0);
+    if (wantStdDev) result.stdDev.assign(sliceBytes, 0);
+    if (wantDepth) result.mipDepth.assign(sliceBytes, minZ);
+    if (!hasRange) {
+        return result;
+    }
+
+    const SlabIndex* index = volume.getSlabIndex();
+    bool indexCovers = index && index->matches(volume) && !wantStdDev && !wantDepth &&
+                       (!wantAip || index->hasSums()) && (!(wantMip || wantMinip) || index->hasExtrema());
+    if (indexCovers) {
+        if (wantMip) index->maximum(volume, minZ, maxZ + 1, result.mip.data(), threadCount);
+        if (wantMinip) index->minimum(volume, minZ, maxZ + 1, result.minip.data(), threadCount);
+        if (wantAip) index->average(minZ, maxZ + 1, result.aip.data(), threadCount);
+        return result;
+    }
+
+    const unsigned char* allData = volume.getData();
+    uint32_t count = static_cast<uint32_t>(maxZ - minZ + 1);
+    // Slices that can be squared into a 32-bit accumulator before it may overflow
+    const int squareFlushInterval = static_cast<int>(std::numeric_limits<uint32_t>::max() / (255u * 255u));
+
+    Parallel::parallelForChunks(sliceBytes, projectionChunkBytes, [&](std::size_t offset, std::size_t length) {
+        std::vector<unsigned char> localMax;
+        unsigned char* maxRow = nullptr;
+        if (wantMip) {
+            maxRow = result.mip.data() + offset;
+        } else if (wantDepth) {
+            localMax.assign(length, 0);
+            maxRow = localMax.data();
+        }
+        unsigned char* minRow = wantMinip ? result.minip.data() + offset : nullptr;
+        int32_t* depthRow = wantDepth ? result.mipDepth.data() + offset : nullptr;
+        std::vector<uint32_t> sumRow(wantAip || wantStdDev ? length : 0, 0);
+        std::vector<uint32_t> squareRow(wantStdDev ? length : 0, 0);
+        std::vector<uint64_t> squareTotal(wantStdDev ? length : 0, 0);
+
+        for (int z = minZ; z <= maxZ; ++z) {
+            const unsigned char* row = allData + z * sliceBytes + offset;
+            if (depthRow) {
+                SimdOps::maxBytesWithIndex(maxRow, depthRow, row, length, z);
+            } else if (maxRow) {
+                SimdOps::maxBytes(maxRow, row, length);
+            }
+            if (minRow) {
+                SimdOps::minBytes(minRow, row, length);
+            }
+            if (!sumRow.empty()) {
+                SimdOps::accumulateBytes(sumRow.data(), row, length);
+            }
+            if (wantStdDev) {
+                SimdOps::accumulateSquares(squareRow.data(), row, length);
+                if ((z - minZ + 1) % squareFlushInterval == 0) {
+                    for (std::size_t i = 0; i < length; ++i) {
+                        squareTotal[i] += squareRow[i];
+                        squareRow[i] = 0;
+                    }
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < length; ++i) {
+            if (wantAip) {
+                result.aip[offset + i] = static_cast<unsigned char>(sumRow[i] / count);
+            }
+            if (wantStdDev) {
+                double mean = static_cast<double>(sumRow[i]) / count;
+                double meanSquare = static_cast<double>(squareTotal[i] + squareRow[i]) / count;
+                double deviation = std::sqrt(std::max(meanSquare - mean * mean, 0.0));
+                result.stdDev[offset + i] = static_cast<unsigned char>(std::min(std::lround(deviation), 255L));
+            }
+        }
+    }, threadCount);
+    return result;
+}
+
+/**
+ * @brief Projects a series of equally thick slabs in one sweep through the volume.
+ *
+ * The slabs [s, s + thickness) start at minZ, minZ + step, ... and end at or before maxZ. Each voxel is
+ * touched a constant number of times however thick the slabs are:
+ *   - AIP keeps a running 32-bit sum per pixel: every slice is added when it enters the window and
+ *     subtracted when it leaves.
+ *   - MIP and MinIP use the van Herk / Gil-Werman scheme. The range is cut into blocks of `thickness`
+ *     slices; a running prefix extremum is kept within the current block and, whenever a block ends,
+ *     its suffix extrema are computed backwards. A window ending in block b starts in block b - 1, so
+ *     its extremum is one combine of the suffix of b - 1 and the prefix of b.
+ * Unlike per-pixel monotonic deques this works on whole rows with the SimdOps kernels. It keeps
+ * `thickness` slices of suffix extrema per requested extremum.
+ *
+ * The slices are swept in batches: each task takes a fixed chunk of bytes through every slice of the
+ * batch, and the slabs finished in the batch (up to slabSeriesBufferBytes of them) are emitted after it.
+ *
+ * @param volume The 3D volume to project.
+ * @param outputs A mask of MipOutput, MinipOutput and AipOutput; other outputs are ignored.
+ * @param thickness The number of slices in every slab.
+ * @param step The distance in slices between the first slices of consecutive slabs.
+ * @param emit Called on the calling thread with each completed slab, in order of z. The set's
+ *             minZ and maxZ give the slab's 0-based slice range; its buffers are reused afterwards.
+ * @param minZ The first slice (1-based) of the series.
+ * @param maxZ The last slice (1-based, inclusive) any slab may reach.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void Projection::projectSlabSeries(const Volume& volume, int outputs, int thickness, int step,
+                                   const std::function<void(const ProjectionSet&)>& emit,
+                                   int minZ, int maxZ, int threadCount) {
+    outputs &= MipOutput | MinipOutput | AipOutput;
+    if (thickness <= 0 || step <= 0 || outputs == 0 || !resolveRange(volume, minZ, maxZ) || maxZ - minZ + 1 < thickness) {
+        return;
+    }
+
+    bool wantMip = outputs & MipOutput, wantMinip = outputs & MinipOutput, wantAip = outputs & AipOutput;
+    std::size_t sliceBytes = volume.getZStride();
+    ProjectionSet slab;
+    slab.width = volume.getWidth();
+    slab.height = volume.getHeight();
+    slab.channels = volume.getChannels();
+    if (wantMip) slab.mip.assign(sliceBytes, 0);
+    if (wantMinip) slab.minip.assign(sliceBytes, 0);
+    if (wantAip) slab.aip.assign(sliceBytes, 0);
+
+    std::size_t blockBytes = static_cast<std::size_t>(thickness) * sliceBytes;
+    std::vector<unsigned char> maxPrefix(wantMip ? sliceBytes : 0), maxSuffix(wantMip ? blockBytes : 0);
+    std::vector<unsigned char> minPrefix(wantMinip ? sliceBytes : 0), minSuffix(wantMinip ? blockBytes : 0);
+    std::vector<uint32_t> sumRow(wantAip ? sliceBytes : 0, 0);
+
+    // Slabs completed in one batch are buffered and emitted together after it
+    int outputCount = wantMip + wantMinip + wantAip;
+    int count = maxZ - minZ + 1;
+    int slabCount = (count - thickness) / step + 1;
+    int slabsPerBatch = static_cast<int>(std::max<std::size_t>(1, slabSeriesBufferBytes / (sliceBytes * outputCount)));
+    slabsPerBatch = std::min(slabsPerBatch, slabCount);
+    std::vector<ProjectionSet> slabs(slabsPerBatch, slab);
+
+    const unsigned char* firstSlice = volume.getData() + minZ * sliceBytes;
+    for (int firstSlab = 0; firstSlab < slabCount; firstSlab += slabsPerBatch) {
+        int batchSlabs = std::min(slabsPerBatch, slabCount - firstSlab);
+        // Slices up to the last one of the batch's last slab; the next batch resumes after it
+        int tBegin = firstSlab == 0 ? 0 : (firstSlab - 1) * step + thickness;
+        int tEnd = (firstSlab + batchSlabs - 1) * step + thickness;
+
+        // Every task sweeps its own bytes through all slices of the batch, so the worker threads are
+        // started once per batch rather than once per slice
+        Parallel::parallelForChunks(sliceBytes, projectionChunkBytes, [&](std::size_t offset, std::size_t length) {
+            for (int t = tBegin; t < tEnd; ++t) {
+                int phase = t % thickness;         // position of slice t within its block
+                int start = t - thickness + 1;     // first slice of the window ending at t
+                bool emitting = start >= 0 && start % step == 0;
+                const unsigned char* row = firstSlice + t * sliceBytes + offset;
+                if (wantMip) {
+                    if (phase == 0) std::memcpy(maxPrefix.data() + offset, row, length);
+                    else SimdOps::maxBytes(maxPrefix.data() + offset, row, length);
+                }
+                if (wantMinip) {
+                    if (phase == 0) std::memcpy(minPrefix.data() + offset, row, length);
+                    else SimdOps::minBytes(minPrefix.data() + offset, row, length);
+                }
+                if (wantAip) {
+                    SimdOps::accumulateBytes(sumRow.data() + offset, row, length);
+                }
+
+                if (emitting) {
+                    ProjectionSet& out = slabs[start / step - firstSlab];
+                    // Unless the window is exactly one block, it also covers the suffix of the previous block
+                    std::size_t suffixOffset = (start % thickness) * sliceBytes + offset;
+                    if (wantMip) {
+                        std::memcpy(out.mip.data() + offset, maxPrefix.data() + offset, length);
+                        if (phase != thickness - 1) SimdOps::maxBytes(out.mip.data() + offset, maxSuffix.data() + suffixOffset, length);
+                    }
+                    if (wantMinip) {
+                        std::memcpy(out.minip.data() + offset, minPrefix.data() + offset, length);
+                        if (phase != thickness - 1) SimdOps::minBytes(out.minip.data() + offset, minSuffix.data() + suffixOffset, length);
+                    }
+                    if (wantAip) {
+                        for (std::size_t i = 0; i < length; ++i) {
+                            out.aip[offset + i] = static_cast<unsigned char>(sumRow[offset + i] / thickness);
+                        }
+                    }
+                }
+                if (wantAip && start >= 0) {
+                    SimdOps::subtractBytes(sumRow.data() + offset, firstSlice + start * sliceBytes + offset, length);
+                }
+
+                // The block [start, t] is complete: compute its suffix extrema for the windows ending in the next block
+                if (phase == thickness - 1 && (wantMip || wantMinip)) {
+                    for (int k = thickness - 1; k >= 0; --k) {
+                        const unsigned char* blockRow = firstSlice + (start + k) * sliceBytes + offset;
+                        std::size_t at = k * sliceBytes + offset;
+                        if (wantMip) {
+                            std::memcpy(maxSuffix.data() + at, blockRow, length);
+                            if (k + 1 < thickness) SimdOps::maxBytes(maxSuffix.data() + at, maxSuffix.data() + at + sliceBytes, length);
+                        }
+                        if (wantMinip) {
+                            std::memcpy(minSuffix.data() + at, blockRow, length);
+                            if (k + 1 < thickness) SimdOps::minBytes(minSuffix.data() + at, minSuffix.data() + at + sliceBytes, length);
+                        }
+                    }
+                }
+            }
+        }, threadCount);
+
+        for (int k = 0; k < batchSlabs; ++k) {
+            slabs[k].minZ = minZ + (firstSlab + k) * step;
+            slabs[k].maxZ = slabs[k].minZ + thickness - 1;
+            emit(slabs[k]);
+        }
+    }
+}
+
+/**
+ * @brief Saves every projection held by a ProjectionSet as a PNG file.
+ *
+ * The depth map is stretched so that the first slice of the range is black and the last is white.
+ *
+ * @param projections The projections to save.
+ * @param prefix The text placed before the projection name, typically the output directory and "/".
+ * @param suffix The text placed between the projection name and ".png".
+ */
+void Projection::saveProjections(const ProjectionSet& projections, const std::string& prefix, const std::string& suffix) {
+    int width = projections.width, height = projections.height, channels = projections.channels;
+    if (!projections.mip.empty()) writeProjection(prefix + "mip" + suffix + ".png", width, height, channels, projections.mip);
+    if (!projections.minip.empty()) writeProjection(prefix + "minip" + suffix + ".png", width, height, channels, projections.minip);
+    if (!projections.aip.empty()) writeProjection(prefix + "aip" + suffix + ".png", width, height, channels, projections.aip);
+    if (!projections.stdDev.empty()) writeProjection(prefix + "stddev" + suffix + ".png", width, height, channels, projections.stdDev);
+    if (!projections.mipDepth.empty()) {
+        int span = std::max(projections.maxZ - projections.minZ, 1);
+        std::vector<unsigned char> depthImage(projections.mipDepth.size());
+        for (std::size_t i = 0; i < depthImage.size(); ++i) {
+            depthImage[i] = static_cast<unsigned char>(((projections.mipDepth[i] - projections.minZ) * 255 + span / 2) / span);
+        }
+        writeProjection(prefix + "mipdepth" + suffix + ".png", width, height, channels, depthImage);
+    }
+}
+
+/**
+ * @brief Computes a Maximum Intensity Projection (MIP) of a range of slices.
+ *
+ * @param volume The 3D volume to project.
+ * @param minZ The starting slice index (1-based) of the projection range.
+ * @param maxZ The ending slice index (1-based, inclusive) of the projection range.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return The projection, width * height * channels bytes; all zero if the range is empty.
+ */
+std::vector<unsigned char> Projection::computeMip(const Volume& volume, int minZ, int maxZ, int threadCount) {
+    return std::move(computeProjections(volume, MipOutput, minZ, maxZ, threadCount).mip);
+}
+
+/**
+ * @brief Computes a Minimum Intensity Projection (MinIP) of a range of slices.
+ *
+ * @param volume The 3D volume to project.
+ * @param minZ The starting slice index (1-based) of the projection range.
+ * @param maxZ The ending slice index (1-based, inclusive) of the projection range.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return The projection, width * height * channels bytes; all 255 if the range is empty.
+ */
+std::vector<unsigned char> Projection::computeMinip(const Volume& volume, int minZ, int maxZ, int threadCount) {
+    return std::move(computeProjections(volume, MinipOutput, minZ, maxZ, threadCount).minip);
+}
+
+/**
+ * @brief Computes an Average Intensity Projection (AIP) of a range of slices.
+ *
+ * Intensities are summed into 32-bit accumulators and the mean is truncated to an integer.
+ *
+ * @param volume The 3D volume to project.
+ * @param minZ The starting slice index (1-based) of the projection range.
+ * @param maxZ The ending slice index (1-based, inclusive) of the projection range.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return The projection, width * height * channels bytes; all zero if the range is empty.
+ */
+std::vector<unsigned char> Projection::computeAip(const Volume& volume, int minZ, int maxZ, int threadCount) {
+    return std::move(computeProjections(volume, AipOutput, minZ, maxZ, threadCount).aip);
+}
+
 /**
  * @brief Generates a Maximum Intensity Projection (MIP) from a given volume.
  *
@@ -40,32 +401,7 @@
  * @param maxZ The ending slice index for the projection range.
  */
 void Projection::mip(const Volume& volume, const std::string& outputPath, int minZ, int maxZ) {
-    int width = volume.getWidth();
-    int height = volume.getHeight();
-    int channels = volume.getChannels();
-    std::vector<unsigned char> projectionData(width * height * channels, 0);
-
-    const auto& allData = volume.getData(); // Correctly access all volume data once
-
-    // Adjust for 1-based indexing and validate range
-    minZ = std::max(minZ - 1, 0); // Ensure not below 0
-    maxZ = std::min(maxZ - 1, static_cast<int>(allData.size()) - 1); // Ensure not beyond the last index
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            unsigned char maxIntensity = 0;
-            for (int z = minZ; z <= maxZ; ++z) {
-                const auto& sliceData = allData[z]; // Access specific slice
-                unsigned char intensity = sliceData[(y * width + x) * channels];
-                if (intensity > maxIntensity) {
-                    maxIntensity = intensity;
-                }
-            }
-            projectionData[(y * width + x) * channels] = maxIntensity;
-        }
-    }
-
-    stbi_write_png(outputPath.c_str(), width, height, channels, projectionData.data(), width * channels);
+    writeProjection(outputPath, volume.getWidth(), volume.getHeight(), volume.getChannels(), computeMip(volume, minZ, maxZ));
 }
 
 /**
@@ -81,32 +417,7 @@ void Projection::mip(const Volume& volume, const std::string& outputPath, int mi
  * @param maxZ The ending slice index for the projection range.
  */
 void Projection::minip(const Volume& volume, const std::string& outputPath, int minZ, int maxZ) {
-    int width = volume.getWidth();
-    int height = volume.getHeight();
-    int channels = volume.getChannels();
-    std::vector<unsigned char> projectionData(width * height * channels, std::numeric_limits<unsigned char>::max());
-
-    const auto& allData = volume.getData(); // Correctly access all volume data once
-
-    // Adjust for 1-based indexing and validate range
-    minZ = std::max(minZ - 1, 0);
-    maxZ = std::min(maxZ - 1, volume.getDepth() - 1);
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            unsigned char minIntensity = std::numeric_limits<unsigned char>::max();
-            for (int z = minZ; z <= maxZ; ++z) {
-                const auto& sliceData = allData[z]; // Get slice data for z
-                unsigned char intensity = sliceData[(y * width + x) * channels];
-                if (intensity < minIntensity) {
-                    minIntensity = intensity;
-                }
-            }
-            projectionData[(y * width + x) * channels] = minIntensity; // Correct indexing for multi-channel support
-        }
-    }
-
-    stbi_write_png(outputPath.c_str(), width, height, channels, projectionData.data(), width * channels);
+    writeProjection(outputPath, volume.getWidth(), volume.getHeight(), volume.getChannels(), computeMinip(volume, minZ, maxZ));
 }
 
 /**
@@ -122,29 +433,5 @@ void Projection::minip(const Volume& volume, const std::string& outputPath, int
  * @param maxZ The ending slice index for the projection range.
  */
 void Projection::aip(const Volume& volume, const std::string& outputPath, int minZ, int maxZ) {
-    int width = volume.getWidth();
-    int height = volume.getHeight();
-    int channels = volume.getChannels();
-    std::vector<unsigned char> projectionData(width * height * channels, 0);
-
-    const auto& allData = volume.getData(); // Correctly access all volume data once
-
-
-
-    // Adjust for 1-based indexing and validate range
-    minZ = std::max(minZ - 1, 0);
-    maxZ = std::min(maxZ - 1, volume.getDepth() - 1);
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            unsigned long long totalIntensity = 0;
-            for (int z = minZ; z <= maxZ; ++z) {
-                const auto& sliceData = allData[z]; // Get slice data for z
-                totalIntensity += sliceData[(y * width + x) * channels];
-            }
-            projectionData[(y * width + x) * channels] = static_cast<unsigned char>(totalIntensity / (maxZ - minZ + 1)); // Correct indexing for multi-channel support
-        }
-    }
-
-    stbi_write_png(outputPath.c_str(), width, height, channels, projectionData.data(), width * channels);
+    writeProjection(outputPath, volume.getWidth(), volume.getHeight(), volume.getChannels(), computeAip(volume, minZ, maxZ));
 }
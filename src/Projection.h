@@ -11,6 +11,27 @@
 #include <string>
 #include <limits>
 #include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+// Outputs of Projection::computeProjections; combine several with |.
+enum ProjectionOutput {
+    MipOutput = 1 << 0,      // Maximum intensity
+    MinipOutput = 1 << 1,    // Minimum intensity
+    AipOutput = 1 << 2,      // Average intensity
+    StdDevOutput = 1 << 3,   // Standard deviation of the intensities
+    MipDepthOutput = 1 << 4  // Slice index of the maximum intensity
+};
+
+// Projections computed together in one pass. Each image holds width x height pixels with the
+// volume's channels interleaved; outputs that were not requested are left empty.
+struct ProjectionSet {
+    int width = 0, height = 0, channels = 0;
+    int minZ = 0, maxZ = -1; // 0-based inclusive slice range that was projected
+    std::vector<unsigned char> mip, minip, aip, stdDev;
+    std::vector<int32_t> mipDepth; // 0-based slice index of the first maximum
+};
 
 class Projection {
 public:
@@ -20,6 +41,31 @@ public:
     static void mip(const Volume& volume, const std::string& outputPath, int minZ = 1, int maxZ = std::numeric_limits<int>::max());
     static void minip(const Volume& volume, const std::string& outputPath, int minZ = 1, int maxZ = std::numeric_limits<int>::max());
     static void aip(const Volume& volume, const std::string& outputPath, int minZ = 1, int maxZ = std::numeric_limits<int>::max());
+
+    // In-memory variants: return a width x height image with the volume's channels interleaved.
+    // threadCount <= 0 uses Parallel::getThreadCount().
+    static std::vector<unsigned char> computeMip(const Volume& volume, int minZ = 1, int maxZ = std::numeric_limits<int>::max(), int threadCount = 0);
+    static std::vector<unsigned char> computeMinip(const Volume& volume, int minZ = 1, int maxZ = std::numeric_limits<int>::max(), int threadCount = 0);
+    static std::vector<unsigned char> computeAip(const Volume& volume, int minZ = 1, int maxZ = std::numeric_limits<int>::max(), int threadCount = 0);
+
+    // Computes every output selected in the ProjectionOutput mask with a single pass over the voxels.
+    static ProjectionSet computeProjections(const Volume& volume, int outputs, int minZ = 1, int maxZ = std::numeric_limits<int>::max(), int threadCount = 0);
+
+    // Projects every slab of the given thickness whose first slice is minZ, minZ + step, ... and
+    // passes each ProjectionSet to emit as soon as it is complete (MIP, MinIP and AIP only).
+    // The set passed to emit is reused for the next slab.
+    static void projectSlabSeries(const Volume& volume, int outputs, int thickness, int step,
+                                  const std::function<void(const ProjectionSet&)>& emit,
+                                  int minZ = 1, int maxZ = std::numeric_limits<int>::max(), int threadCount = 0);
+
+    // Saves every output of the set as "<prefix><name><suffix>.png" (names: mip, minip, aip, stddev, mipdepth).
+    static void saveProjections(const ProjectionSet& projections, const std::string& prefix, const std::string& suffix);
+
+private:
+    // Converts a 1-based inclusive range to 0-based and clamps it to the volume; false if empty.
+    static bool resolveRange(const Volume& volume, int& minZ, int& maxZ);
+
+    static void writeProjection(const std::string& outputPath, int width, int height, int channels, const std::vector<unsigned char>& projection);
 };
 
 #endif // PROJECTION_H
@@ -7,9 +7,15 @@
 #include "ProjectionTest.h"
 #include "Volume.h"
 #include "Projection.h"
+#include "SlabIndex.h"
+#include "Slice.h"
 #include "Image.h"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
 
 namespace fs = std::filesystem;
 void ProjectionTest::run(int testType) {
@@ -18,6 +24,20 @@ void ProjectionTest::run(int testType) {
         fs::create_directories(outputDir);
     }
 
+    // The slab and slice tests build their own small volumes
+    if (testType == TestSlabIndex) {
+        testSlabIndex();
+        return;
+    }
+    if (testType == TestSlabSeries) {
+        testSlabSeries();
+        return;
+    }
+    if (testType == TestSlices) {
+        testSlices(outputDir);
+        return;
+    }
+
     Volume volume;
     if (!volume.loadVolume("../Scans/confuciusornis")) {
         std::cerr << "Failed to load volume from scans." << std::endl;
@@ -54,7 +74,6 @@ void ProjectionTest::testMIP(const Volume& volume, const std::string& outputDir)
         return;
     }
 
-    const auto& volumeData = volume.getData();
     int width = mipImage.getWidth();
     int height = mipImage.getHeight();
     int channels = mipImage.getChannels();
@@ -66,7 +85,7 @@ void ProjectionTest::testMIP(const Volume& volume, const std::string& outputDir)
         for (int x = 0; x < width; ++x) {
             unsigned char maxIntensity = 0;
             for (int z = 0; z < volume.getDepth(); ++z) {
-                const auto& slice = volumeData[z];
+                SliceView<const unsigned char> slice = volume.getSlice(z);
                 unsigned char sliceIntensity = slice[(y * width + x) * channels];
                 if (sliceIntensity > maxIntensity) {
                     maxIntensity = sliceIntensity;
@@ -104,7 +123,6 @@ void ProjectionTest::testMINIP(const Volume& volume, const std::string& outputDi
         return;
     }
 
-    const auto& volumeData = volume.getData();
     int width = minipImage.getWidth();
     int height = minipImage.getHeight();
     int channels = minipImage.getChannels();
@@ -116,7 +134,7 @@ void ProjectionTest::testMINIP(const Volume& volume, const std::string& outputDi
         for (int x = 0; x < width; ++x) {
             unsigned char minIntensity = std::numeric_limits<unsigned char>::max();
             for (int z = 0; z < volume.getDepth(); ++z) {
-                const auto& slice = volumeData[z];
+                SliceView<const unsigned char> slice = volume.getSlice(z);
                 unsigned char sliceIntensity = slice[(y * width + x) * channels];
                 if (sliceIntensity < minIntensity) {
                     minIntensity = sliceIntensity;
@@ -154,7 +172,6 @@ void ProjectionTest::testAIP(const Volume& volume, const std::string& outputDir)
         return;
     }
 
-    const auto& volumeData = volume.getData();
     int width = aipImage.getWidth();
     int height = aipImage.getHeight();
     int channels = aipImage.getChannels();
@@ -166,7 +183,7 @@ void ProjectionTest::testAIP(const Volume& volume, const std::string& outputDir)
         for (int x = 0; x < width; ++x) {
             unsigned long long totalIntensity = 0;
             for (int z = 0; z < volume.getDepth(); ++z) {
-                const auto& slice = volumeData[z];
+                SliceView<const unsigned char> slice = volume.getSlice(z);
                 totalIntensity += slice[(y * width + x) * channels];
             }
             unsigned char expectedAverage = static_cast<unsigned char>(totalIntensity / volume.getDepth());
@@ -187,4 +204,177 @@ void ProjectionTest::testAIP(const Volume& volume, const std::string& outputDir)
     } else {
         std::cerr << "AIP Test Failed: Discrepancy in average intensity values." << std::endl;
     }
+}
+
+Volume ProjectionTest::randomVolume(int width, int height, int depth, int channels, unsigned int seed) {
+    Volume volume(width, height, depth, channels);
+    std::mt19937 random(seed);
+    for (std::size_t i = 0; i < volume.getVoxelCount(); ++i) {
+        volume.getData()[i] = static_cast<unsigned char>(random());
+    }
+    return volume;
+}
+
+void ProjectionTest::bruteForceSlab(const Volume& volume, int zBegin, int zEnd, std::vector<unsigned char>& mip,
+                                    std::vector<unsigned char>& minip, std::vector<unsigned char>& aip) {
+    std::size_t sliceBytes = volume.getZStride();
+    mip.assign(sliceBytes, 0);
+    minip.assign(sliceBytes, 255);
+    aip.assign(sliceBytes, 0);
+    for (std::size_t i = 0; i < sliceBytes; ++i) {
+        unsigned int sum = 0;
+        for (int z = zBegin; z < zEnd; ++z) {
+            unsigned char value = volume.getData()[z * sliceBytes + i];
+            mip[i] = std::max(mip[i], value);
+            minip[i] = std::min(minip[i], value);
+            sum += value;
+        }
+        aip[i] = static_cast<unsigned char>(sum / (zEnd - zBegin));
+    }
+}
+
+// Tests the slab index. On a small random volume the index's prefix sums and max/min pyramids
+// must give the same AIP, MIP and MinIP as a loop over the slices for every slab [zBegin, zEnd),
+// from single slices to the full depth, both queried directly and through the Projection
+// functions once the index is attached to the volume. Replacing the data with setData() must drop
+// the index, so that projections of the new data are not answered from the old summaries.
+void ProjectionTest::testSlabIndex() {
+    const int width = 9, height = 7, depth = 13, channels = 2;
+    Volume volume = randomVolume(width, height, depth, channels, 2024);
+    auto index = std::make_shared<SlabIndex>(volume);
+    volume.setSlabIndex(index);
+
+    std::size_t sliceBytes = volume.getZStride();
+    std::vector<unsigned char> mip, minip, aip, indexed(sliceBytes);
+    int mismatches = 0;
+    for (int zBegin = 0; zBegin < depth; ++zBegin) {
+        for (int zEnd = zBegin + 1; zEnd <= depth; ++zEnd) {
+            bruteForceSlab(volume, zBegin, zEnd, mip, minip, aip);
+            index->maximum(volume, zBegin, zEnd, indexed.data());
+            mismatches += indexed != mip;
+            index->minimum(volume, zBegin, zEnd, indexed.data());
+            mismatches += indexed != minip;
+            index->average(zBegin, zEnd, indexed.data());
+            mismatches += indexed != aip;
+            // The Projection functions take 1-based inclusive ranges and answer from the attached index
+            mismatches += Projection::computeMip(volume, zBegin + 1, zEnd) != mip;
+            mismatches += Projection::computeMinip(volume, zBegin + 1, zEnd) != minip;
+            mismatches += Projection::computeAip(volume, zBegin + 1, zEnd) != aip;
+        }
+    }
+
+    Volume replacement = randomVolume(width, height, depth, channels, 2025);
+    VoxelBuffer newData(replacement.getData(), replacement.getData() + replacement.getVoxelCount());
+    volume.setData(std::move(newData));
+    bruteForceSlab(replacement, 0, depth, mip, minip, aip);
+    bool indexDropped = volume.getSlabIndex() == nullptr && Projection::computeMip(volume) == mip &&
+                        Projection::computeAip(volume) == aip;
+
+    if (mismatches == 0 && indexDropped) {
+        std::cout << "Slab Index Test Passed: MIP, MinIP and AIP of every slab of a 9x7x13 volume match a loop over "
+                  << "the slices, and setData() drops the index." << std::endl;
+    } else {
+        std::cerr << "Slab Index Test Failed: " << mismatches << " slab projections differ from a loop over the slices"
+                  << (indexDropped ? "." : ", and setData() did not drop the index.") << std::endl;
+    }
+}
+
+// Tests the slab series. For several thicknesses and steps, including single-slice slabs and steps
+// larger than the thickness (which skip slices), every slab emitted by projectSlabSeries must match
+// the MIP, MinIP and AIP of the same slices computed one slab at a time, and the slabs must arrive
+// in order with nothing missing. The volume's slices are larger than one task's chunk, so the
+// sweep is split over several threads.
+void ProjectionTest::testSlabSeries() {
+    const int width = 150, height = 60, depth = 23, channels = 2;
+    Volume volume = randomVolume(width, height, depth, channels, 2024);
+
+    const int thicknesses[] = { 1, 2, 3, 5, 8 };
+    const int steps[] = { 1, 2, 3, 7 };
+    int mismatches = 0, missing = 0;
+    std::vector<unsigned char> mip, minip, aip;
+    for (int thickness : thicknesses) {
+        for (int step : steps) {
+            int next = 0; // 0-based first slice of the next expected slab
+            Projection::projectSlabSeries(volume, MipOutput | MinipOutput | AipOutput, thickness, step,
+                                          [&](const ProjectionSet& slab) {
+                if (slab.minZ != next || slab.maxZ != next + thickness - 1) {
+                    ++missing;
+                }
+                bruteForceSlab(volume, slab.minZ, slab.maxZ + 1, mip, minip, aip);
+                mismatches += (slab.mip != mip) + (slab.minip != minip) + (slab.aip != aip);
+                next = slab.minZ + step;
+            }, 1, depth, 4);
+            // Every slab that fits was emitted
+            if (next != ((depth - thickness) / step + 1) * step) {
+                ++missing;
+            }
+        }
+    }
+
+    if (mismatches == 0 && missing == 0) {
+        std::cout << "Slab Series Test Passed: Every slab for thicknesses 1 to 8 and steps 1 to 7 matches "
+                  << "its MIP, MinIP and AIP computed on its own." << std::endl;
+    } else {
+        std::cerr << "Slab Series Test Failed: " << mismatches << " projections differ and " << missing
+                  << " series emitted slabs out of order or missed some." << std::endl;
+    }
+}
+
+// Tests the batch slice extraction. Every XZ and YZ slice extracted from a random volume, and the
+// XZY and YZX permutations, must match the voxels read one by one as the original sliceXZ/sliceYZ
+// loops did. The volume is not a multiple of the 32-voxel transpose tile in any direction, so the
+// partial tiles at the edges are covered. Extracting a subset must give the same slices in the
+// requested order, and the PNGs written by sliceXZ and sliceYZ must hold the same pixels.
+void ProjectionTest::testSlices(const std::string& outputDir) {
+    const int width = 37, height = 45, depth = 11, channels = 3;
+    Volume volume = randomVolume(width, height, depth, channels, 2024);
+
+    Volume xz = Slice::permute(volume, XZY, 4);
+    Volume yz = Slice::permute(volume, YZX, 4);
+    int mismatches = 0;
+    for (int z = 0; z < depth; ++z) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                for (int ch = 0; ch < channels; ++ch) {
+                    unsigned char voxel = volume.getData()[volume.index(x, y, z) + ch];
+                    mismatches += xz.getData()[xz.index(x, z, y) + ch] != voxel;
+                    mismatches += yz.getData()[yz.index(y, z, x) + ch] != voxel;
+                }
+            }
+        }
+    }
+
+    // A subset, out of order and with the first and last slices, picks the same planes
+    const std::vector<int> indices = { 3, 1, 37 };
+    Volume xzSubset = Slice::extractXZ(volume, indices, 2);
+    Volume yzSubset = Slice::extractYZ(volume, indices, 2);
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        const unsigned char* xzSlice = xz.getData() + (indices[i] - 1) * xz.getZStride();
+        const unsigned char* yzSlice = yz.getData() + (indices[i] - 1) * yz.getZStride();
+        mismatches += !std::equal(xzSlice, xzSlice + xz.getZStride(), xzSubset.getData() + i * xz.getZStride());
+        mismatches += !std::equal(yzSlice, yzSlice + yz.getZStride(), yzSubset.getData() + i * yz.getZStride());
+    }
+
+    // The single-slice wrappers save the same planes as PNG files
+    std::string xzPath = outputDir + "/testVolume_XZ.png", yzPath = outputDir + "/testVolume_YZ.png";
+    Slice::sliceXZ(volume, 5, xzPath);
+    Slice::sliceYZ(volume, 7, yzPath);
+    Image xzImage, yzImage;
+    if (!xzImage.loadImage(xzPath) || !yzImage.loadImage(yzPath)) {
+        std::cerr << "Failed to load the saved slices for verification." << std::endl;
+        return;
+    }
+    const unsigned char* xzExpected = xz.getData() + 4 * xz.getZStride();
+    const unsigned char* yzExpected = yz.getData() + 6 * yz.getZStride();
+    mismatches += xzImage.getWidth() != width || xzImage.getHeight() != depth ||
+                  !std::equal(xzExpected, xzExpected + xz.getZStride(), xzImage.getData());
+    mismatches += yzImage.getWidth() != height || yzImage.getHeight() != depth ||
+                  !std::equal(yzExpected, yzExpected + yz.getZStride(), yzImage.getData());
+
+    if (mismatches == 0) {
+        std::cout << "XZ and YZ Slices Test Passed: Extracted, permuted and saved slices of a 37x45x11 volume "
+                  << "match its voxels." << std::endl;
+    } else {
+        std::cerr << "XZ and YZ Slices Test Failed: " << mismatches << " voxels or slices differ." << std::endl;
+    }
 }
\ No newline at end of file
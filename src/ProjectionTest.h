@@ -14,6 +14,9 @@ enum TestType {
     TestMIP,
     TestMINIP,
     TestAIP,
+    TestSlabIndex,
+    TestSlabSeries,
+    TestSlices,
     // Add more test types as necessary
 };
 
@@ -26,6 +29,16 @@ public:
     void testMIP(const Volume& volume, const std::string& outputDir);
     void testMINIP(const Volume& volume, const std::string& outputDir);
     void testAIP(const Volume& volume, const std::string& outputDir);
+    void testSlabIndex();
+    void testSlabSeries();
+    void testSlices(const std::string& outputDir);
+
+private:
+    // A width x height x depth volume with random voxels from a fixed seed
+    static Volume randomVolume(int width, int height, int depth, int channels, unsigned int seed);
+    // MIP, MinIP and AIP of the 0-based slices [zBegin, zEnd), computed voxel by voxel
+    static void bruteForceSlab(const Volume& volume, int zBegin, int zEnd, std::vector<unsigned char>& mip,
+                               std::vector<unsigned char>& minip, std::vector<unsigned char>& aip);
 };
 
 #endif // PROJECTIONTEST_H
\ No newline at end of file
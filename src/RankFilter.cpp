@@ -0,0 +1,396 @@
+/**
+ * @file RankFilter.cpp
+ *
+ * @brief Implementation of the RankFilter class for sliding-histogram rank filters.
+ *
+ * The image is split into bands of rows that are filtered in parallel, one channel at a time.
+ * Each band keeps its own histograms, which are allocated once per band, and writes its rows
+ * to a separate output buffer, since neighbouring bands still read the source rows. The adaptive
+ * median reads a copy of the image instead and writes only the impulse pixels back in place.
+ *
+ * Dependencies:
+ *   - RankHistogram.h for the window and column histograms.
+ *   - Parallel.h for filtering bands of rows on worker threads.
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#include "RankFilter.h"
+#include "Parallel.h"
+#include "RankHistogram.h"
+#include "SimdOps.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Converts a percentile to a rank among count values.
+ *
+ * @param percentile The percentile, from 0 (minimum) to 100 (maximum).
+ * @param count The number of values; must be positive.
+ * @return floor(percentile / 100 * count), clamped to [0, count - 1].
+ */
+uint32_t RankFilter::rankOf(double percentile, uint32_t count) {
+    double rank = std::floor(percentile / 100.0 * count);
+    if (rank <= 0.0) {
+        return 0;
+    }
+    return std::min(static_cast<uint32_t>(rank), count - 1);
+}
+
+/**
+ * @brief Applies a rank filter to an image in place.
+ *
+ * @param image The image to filter.
+ * @param kernelSize The size of the square window (odd; kernelSize / 2 pixels on each side).
+ * @param percentile The percentile to select, from 0 (minimum) to 100 (maximum).
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void RankFilter::apply(Image& image, int kernelSize, double percentile, int threadCount) {
+    std::size_t size = static_cast<std::size_t>(image.getWidth()) * image.getHeight() * image.getChannels();
+    std::vector<unsigned char> output(size);
+    apply(image.getData(), output.data(), image.getWidth(), image.getHeight(), image.getChannels(),
+          kernelSize, percentile, threadCount);
+    std::copy(output.begin(), output.end(), image.getData());
+}
+
+/**
+ * @brief Applies a rank filter from a source buffer into an output buffer.
+ *
+ * Kernels up to huangMaxKernel use Huang's algorithm, larger ones Perreault-Hebert: Huang's
+ * cost per pixel grows with k, while Perreault-Hebert pays a fixed cost of two whole-histogram
+ * updates per pixel, which only wins once k is large.
+ *
+ * @param source The interleaved source pixels.
+ * @param output The interleaved destination pixels, laid out like the source.
+ * @param width The image width.
+ * @param height The image height.
+ * @param channels The number of interleaved channels.
+ * @param kernelSize The size of the square window (odd; kernelSize / 2 pixels on each side).
+ * @param percentile The percentile to select, from 0 (minimum) to 100 (maximum).
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void RankFilter::apply(const unsigned char* source, unsigned char* output, int width, int height, int channels,
+                       int kernelSize, double percentile, int threadCount) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    int halfKernel = std::max(kernelSize / 2, 0);
+    bool huang = 2 * halfKernel + 1 <= huangMaxKernel;
+
+    // A few bands per thread balance the load; bands of at least k rows keep the cost of
+    // filling the histograms at the top of each band small
+    int threads = Parallel::resolveThreadCount(threadCount);
+    int bandRows = std::max((height + threads * 4 - 1) / (threads * 4), 2 * halfKernel + 1);
+    Parallel::parallelForChunks(height, bandRows, [&](std::size_t offset, std::size_t length) {
+        int yBegin = static_cast<int>(offset);
+        int yEnd = static_cast<int>(offset + length);
+        for (int c = 0; c < channels; ++c) {
+            if (huang) {
+                huangRows(source, output, width, height, channels, c, halfKernel, percentile, yBegin, yEnd);
+            } else {
+                perreaultHebertRows(source, output, width, height, channels, c, halfKernel, percentile, yBegin, yEnd);
+            }
+        }
+    }, threads);
+}
+
+/**
+ * @brief Filters one channel of the output rows [yBegin, yEnd) with Huang's algorithm.
+ *
+ * The window histogram is filled at the start of each row and then slides along it: moving
+ * one pixel right adds the in-bounds pixels of the column entering the window and removes
+ * those of the column leaving it.
+ *
+ * @param source The interleaved source pixels.
+ * @param output The interleaved destination pixels.
+ * @param width The image width.
+ * @param height The image height.
+ * @param channels The number of interleaved channels.
+ * @param channel The channel to filter.
+ * @param halfKernel The number of pixels on each side of the window centre.
+ * @param percentile The percentile to select.
+ * @param yBegin The first output row.
+ * @param yEnd One past the last output row.
+ */
+void RankFilter::huangRows(const unsigned char* source, unsigned char* output, int width, int height, int channels,
+                           int channel, int halfKernel, double percentile, int yBegin, int yEnd) {
+    std::size_t rowLength = static_cast<std::size_t>(width) * channels;
+    RankHistogram<uint32_t> window;
+
+    for (int y = yBegin; y < yEnd; ++y) {
+        int top = std::max(y - halfKernel, 0);
+        int bottom = std::min(y + halfKernel, height - 1);
+        uint32_t rows = bottom - top + 1;
+        const unsigned char* column = source + top * rowLength + channel;
+
+        auto addColumn = [&](int x) {
+            const unsigned char* p = column + x * channels;
+            for (uint32_t r = 0; r < rows; ++r, p += rowLength) {
+                window.add(*p);
+            }
+        };
+        auto removeColumn = [&](int x) {
+            const unsigned char* p = column + x * channels;
+            for (uint32_t r = 0; r < rows; ++r, p += rowLength) {
+                window.remove(*p);
+            }
+        };
+
+        window.clear();
+        for (int x = 0; x < std::min(halfKernel, width); ++x) {
+            addColumn(x);
+        }
+        unsigned char* out = output + y * rowLength + channel;
+        for (int x = 0; x < width; ++x) {
+            if (x + halfKernel < width) {
+                addColumn(x + halfKernel);
+            }
+            if (x - halfKernel - 1 >= 0) {
+                removeColumn(x - halfKernel - 1);
+            }
+            uint32_t columns = std::min(x + halfKernel, width - 1) - std::max(x - halfKernel, 0) + 1;
+            out[x * channels] = window.select(rankOf(percentile, columns * rows));
+        }
+    }
+}
+
+/**
+ * @brief Filters one channel of the output rows [yBegin, yEnd) with the Perreault-Hebert algorithm.
+ *
+ * Every x keeps a histogram of the in-bounds pixels of its column of the window, which slides
+ * down one row per output row. The window histogram then slides along the row by adding the
+ * column histogram that enters and subtracting the one that leaves, so the work per pixel does
+ * not depend on the kernel size.
+ *
+ * @param source The interleaved source pixels.
+ * @param output The interleaved destination pixels.
+ * @param width The image width.
+ * @param height The image height.
+ * @param channels The number of interleaved channels.
+ * @param channel The channel to filter.
+ * @param halfKernel The number of pixels on each side of the window centre.
+ * @param percentile The percentile to select.
+ * @param yBegin The first output row.
+ * @param yEnd One past the last output row.
+ */
+void RankFilter::perreaultHebertRows(const unsigned char* source, unsigned char* output, int width, int height,
+                                     int channels, int channel, int halfKernel, double percentile, int yBegin, int yEnd) {
+    std::size_t rowLength = static_cast<std::size_t>(width) * channels;
+    std::vector<RankHistogram<uint16_t>> columns(width);
+    RankHistogram<uint32_t> window;
+
+    for (auto& column : columns) {
+        column.clear();
+    }
+    // Start with the columns of row yBegin - 1, so that the first slide below applies to every band
+    for (int y = std::max(yBegin - halfKernel - 1, 0); y < std::min(yBegin + halfKernel, height); ++y) {
+        const unsigned char* row = source + y * rowLength + channel;
+        for (int x = 0; x < width; ++x) {
+            columns[x].add(row[x * channels]);
+        }
+    }
+
+    for (int y = yBegin; y < yEnd; ++y) {
+        // Slide every column down: take in row y + h, drop row y - h - 1
+        if (y + halfKernel < height) {
+            const unsigned char* row = source + (y + halfKernel) * rowLength + channel;
+            for (int x = 0; x < width; ++x) {
+                columns[x].add(row[x * channels]);
+            }
+        }
+        if (y - halfKernel - 1 >= 0) {
+            const unsigned char* row = source + (y - halfKernel - 1) * rowLength + channel;
+            for (int x = 0; x < width; ++x) {
+                columns[x].remove(row[x * channels]);
+            }
+        }
+        uint32_t rows = std::min(y + halfKernel, height - 1) - std::max(y - halfKernel, 0) + 1;
+
+        window.clear();
+        for (int x = 0; x < std::min(halfKernel, width); ++x) {
+            window.addHistogram(columns[x]);
+        }
+        unsigned char* out = output + y * rowLength + channel;
+        for (int x = 0; x < width; ++x) {
+            if (x + halfKernel < width) {
+                window.addHistogram(columns[x + halfKernel]);
+            }
+            if (x - halfKernel - 1 >= 0) {
+                window.subtractHistogram(columns[x - halfKernel - 1]);
+            }
+            uint32_t count = std::min(x + halfKernel, width - 1) - std::max(x - halfKernel, 0) + 1;
+            out[x * channels] = window.select(rankOf(percentile, count * rows));
+        }
+    }
+}
+
+// Rows per work item of the adaptive median
+static const int adaptiveMedianRows = 16;
+
+/**
+ * @brief Calls visit(i) for every byte of a row that is 0 or 255, in order.
+ *
+ * Clean stretches are skipped 16 bytes at a time with SSE2.
+ *
+ * @param row The row.
+ * @param length The number of bytes in the row.
+ * @param visit Called with the offset of each impulse byte.
+ */
+template <typename Visit>
+static void forEachImpulse(const unsigned char* row, std::size_t length, Visit&& visit) {
+    std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi8(static_cast<char>(0xFF));
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        int impulses = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, zero), _mm_cmpeq_epi8(bytes, full)));
+        for (int b = 0; impulses != 0; ++b, impulses >>= 1) {
+            if (impulses & 1) {
+                visit(i + b);
+            }
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        if (row[i] == 0 || row[i] == 255) {
+            visit(i);
+        }
+    }
+}
+
+/**
+ * @brief Finds the adaptive median of one pixel.
+ *
+ * The 3 x 3 window, which settles most impulses, is sorted directly. Larger windows are kept as a
+ * histogram that grows by the ring of pixels at the next distance each step, so a window is never
+ * rebuilt; its minimum and maximum are tracked as pixels are added.
+ *
+ * @param source The unfiltered image.
+ * @param width Width of the image.
+ * @param height Height of the image.
+ * @param channels Number of interleaved channels.
+ * @param x Column of the pixel.
+ * @param y Row of the pixel.
+ * @param channel The channel filtered.
+ * @param maxHalf The largest window reaches maxHalf pixels on each side.
+ * @param window Scratch histogram.
+ * @return The median of the first window whose median is not its minimum or maximum, or of the
+ *         largest window. The pixel itself is an extreme of every window, so it is always replaced.
+ */
+static unsigned char adaptiveMedianAt(const unsigned char* source, int width, int height, int channels, int x, int y,
+                                      int channel, int maxHalf, RankHistogram<uint32_t>& window) {
+    auto pixel = [&](int px, int py) {
+        return source[(static_cast<std::size_t>(py) * width + px) * channels + channel];
+    };
+
+    // 3 x 3 window, insertion-sorted
+    unsigned char values[9] = {};
+    int count = 0;
+    for (int py = std::max(y - 1, 0); py <= std::min(y + 1, height - 1); ++py) {
+        for (int px = std::max(x - 1, 0); px <= std::min(x + 1, width - 1); ++px) {
+            unsigned char value = pixel(px, py);
+            int i = count++;
+            for (; i > 0 && values[i - 1] > value; --i) {
+                values[i] = values[i - 1];
+            }
+            values[i] = value;
+        }
+    }
+    unsigned char lowest = values[0], highest = values[count - 1];
+    unsigned char median = values[RankFilter::rankOf(50.0, count)];
+    if (maxHalf == 1 || (lowest < median && median < highest)) {
+        return median;
+    }
+
+    window.clear();
+    for (int i = 0; i < count; ++i) {
+        window.add(values[i]);
+    }
+    auto addPixel = [&](int px, int py) {
+        unsigned char value = pixel(px, py);
+        window.add(value);
+        lowest = std::min(lowest, value);
+        highest = std::max(highest, value);
+        ++count;
+    };
+    // Adds the in-bounds pixels at Chebyshev distance r from (x, y)
+    auto addRing = [&](int r) {
+        int x0 = std::max(x - r, 0), x1 = std::min(x + r, width - 1);
+        if (y - r >= 0) {
+            for (int px = x0; px <= x1; ++px) {
+                addPixel(px, y - r);
+            }
+        }
+        if (y + r < height) {
+            for (int px = x0; px <= x1; ++px) {
+                addPixel(px, y + r);
+            }
+        }
+        int y0 = std::max(y - r + 1, 0), y1 = std::min(y + r - 1, height - 1);
+        for (int py = y0; py <= y1; ++py) {
+            if (x - r >= 0) {
+                addPixel(x - r, py);
+            }
+            if (x + r < width) {
+                addPixel(x + r, py);
+            }
+        }
+    };
+
+    for (int half = 2;; ++half) {
+        addRing(half);
+        median = window.select(RankFilter::rankOf(50.0, count));
+        if (half == maxHalf || (lowest < median && median < highest)) {
+            return median;
+        }
+    }
+}
+
+/**
+ * @brief Applies an adaptive median filter for impulse (salt and pepper) noise in place.
+ *
+ * Pixels that are neither 0 nor 255 are never visited after the scan that finds the impulses, so
+ * at low noise densities the cost is dominated by the number of noisy pixels.
+ *
+ * @param image The image to filter.
+ * @param maxKernelSize The largest window size (odd; at least 3).
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void RankFilter::adaptiveMedian(Image& image, int maxKernelSize, int threadCount) {
+    int width = image.getWidth();
+    int height = image.getHeight();
+    int channels = image.getChannels();
+    unsigned char* data = image.getData();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Windows past max(width, height) pixels on each side only add empty rings
+    int maxHalf = std::max(std::min(maxKernelSize / 2, std::max(width, height)), 1);
+    int colourChannels = channels == 2 || channels == 4 ? channels - 1 : channels;
+    std::size_t rowLength = static_cast<std::size_t>(width) * channels;
+    // Windows read the unfiltered pixels, so filtered ones are written back to the image directly
+    std::vector<unsigned char> source(data, data + rowLength * height);
+
+    int bands = (height + adaptiveMedianRows - 1) / adaptiveMedianRows;
+    Parallel::parallelFor(0, bands, [&](int band) {
+        RankHistogram<uint32_t> window;
+        int yEnd = std::min(height, (band + 1) * adaptiveMedianRows);
+        for (int y = band * adaptiveMedianRows; y < yEnd; ++y) {
+            const unsigned char* row = source.data() + y * rowLength;
+            unsigned char* out = data + y * rowLength;
+            forEachImpulse(row, rowLength, [&](std::size_t i) {
+                int channel = static_cast<int>(i % channels);
+                if (channel < colourChannels) {
+                    out[i] = adaptiveMedianAt(source.data(), width, height, channels, static_cast<int>(i / channels),
+                                              y, channel, maxHalf, window);
+                }
+            });
+        }
+    }, threadCount);
+}
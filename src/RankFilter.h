@@ -0,0 +1,72 @@
+/**
+ * @file RankFilter.h
+ *
+ * @brief Declaration of the RankFilter class, a sliding-histogram engine for 2D rank filters.
+ *
+ * A rank filter replaces every pixel by the value of a given rank among the pixels of the
+ * k x k window around it: the minimum, the maximum, the median, or any percentile in between.
+ * Only pixels inside the image are counted, so windows shrink at the edges.
+ *
+ * Every window is kept as a RankHistogram that slides instead of being rebuilt, so no memory is
+ * allocated per pixel:
+ *   - Huang's algorithm (small kernels) slides the window histogram along a row, adding the
+ *     column of k pixels that enters it and removing the one that leaves, O(k) per pixel.
+ *   - Perreault-Hebert (large kernels) also keeps one histogram per column that slides down the
+ *     image, and moves the window by adding and subtracting whole column histograms, which costs
+ *     the same at any kernel size.
+ *
+ * The adaptive median only visits impulse pixels (0 or 255) and grows a window histogram around
+ * each of them ring by ring, so its cost follows the amount of salt and pepper noise rather than
+ * the image area times the kernel area.
+ *
+ * Usage:
+ *   RankFilter::median(image, 5);
+ *   RankFilter::apply(image, 31, 90.0); // 90th percentile of each 31 x 31 window
+ *   RankFilter::adaptiveMedian(image, 7); // impulse pixels only, windows of 3 x 3 up to 7 x 7
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef RANKFILTER_H
+#define RANKFILTER_H
+
+#include "Image.h"
+#include <cstdint>
+
+class RankFilter {
+public:
+    // Replaces each pixel by the given percentile (0 = minimum, 50 = median, 100 = maximum)
+    // of the in-bounds pixels of its kernelSize x kernelSize window, per channel.
+    static void apply(Image& image, int kernelSize, double percentile, int threadCount = 0);
+
+    // Same as apply() on raw interleaved data; source and output must not overlap.
+    static void apply(const unsigned char* source, unsigned char* output, int width, int height, int channels,
+                      int kernelSize, double percentile, int threadCount = 0);
+
+    static void median(Image& image, int kernelSize, int threadCount = 0) { apply(image, kernelSize, 50.0, threadCount); }
+    static void minimum(Image& image, int kernelSize, int threadCount = 0) { apply(image, kernelSize, 0.0, threadCount); }
+    static void maximum(Image& image, int kernelSize, int threadCount = 0) { apply(image, kernelSize, 100.0, threadCount); }
+
+    // Adaptive median for impulse noise. Only pixels at 0 or 255 are filtered: each starts with a
+    // 3 x 3 window that grows by 2 until its median lies strictly between the window's minimum and
+    // maximum, or the window reaches maxKernelSize, and takes that median. Other pixels, and the
+    // alpha channel of 2- and 4-channel images, are kept.
+    static void adaptiveMedian(Image& image, int maxKernelSize, int threadCount = 0);
+
+    // 0-based rank of the given percentile among count sorted values: floor(percentile / 100 * count),
+    // clamped to [0, count - 1]. The median of an even count is the upper of the two middle values.
+    static uint32_t rankOf(double percentile, uint32_t count);
+
+    // Largest kernel size filtered with Huang's algorithm; larger kernels use Perreault-Hebert.
+    static const int huangMaxKernel = 23;
+
+private:
+    static void huangRows(const unsigned char* source, unsigned char* output, int width, int height, int channels,
+                          int channel, int halfKernel, double percentile, int yBegin, int yEnd);
+    static void perreaultHebertRows(const unsigned char* source, unsigned char* output, int width, int height,
+                                    int channels, int channel, int halfKernel, double percentile, int yBegin, int yEnd);
+};
+
+#endif // RANKFILTER_H
@@ -0,0 +1,91 @@
+/**
+ * @file RankHistogram.h
+ *
+ * @brief 256-bin histogram with a 16-bin coarse level for sliding-window rank filters.
+ *
+ * RankHistogram counts 8-bit values in a fine 256-bin table and a coarse 16-bin table
+ * (one coarse bin per 16 fine bins). Values and whole histograms can be added and removed,
+ * which lets median and percentile filters slide a window by updating only the data that
+ * enters and leaves it. select() finds the value of a given rank by first walking the
+ * coarse bins and then at most 16 fine bins.
+ *
+ * The counter type is a template parameter so that per-column histograms can use 16-bit
+ * counters (half the cache footprint) while window histograms use 32-bit counters.
+ *
+ * Usage:
+ *   RankHistogram<uint32_t> window;
+ *   window.clear();
+ *   window.add(value);
+ *   unsigned char median = window.select(count / 2);
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef RANKHISTOGRAM_H
+#define RANKHISTOGRAM_H
+
+#include <cstdint>
+#include <cstring>
+
+template <typename Count>
+struct RankHistogram {
+    Count fine[256];
+    Count coarse[16];
+
+    void clear() {
+        std::memset(fine, 0, sizeof(fine));
+        std::memset(coarse, 0, sizeof(coarse));
+    }
+
+    void add(unsigned char value) {
+        ++fine[value];
+        ++coarse[value >> 4];
+    }
+
+    void remove(unsigned char value) {
+        --fine[value];
+        --coarse[value >> 4];
+    }
+
+    // Adds every count of another histogram (e.g. a column entering the window)
+    template <typename Other>
+    void addHistogram(const RankHistogram<Other>& other) {
+        for (int i = 0; i < 256; ++i) {
+            fine[i] += other.fine[i];
+        }
+        for (int i = 0; i < 16; ++i) {
+            coarse[i] += other.coarse[i];
+        }
+    }
+
+    // Removes every count of another histogram (e.g. a column leaving the window)
+    template <typename Other>
+    void subtractHistogram(const RankHistogram<Other>& other) {
+        for (int i = 0; i < 256; ++i) {
+            fine[i] -= other.fine[i];
+        }
+        for (int i = 0; i < 16; ++i) {
+            coarse[i] -= other.coarse[i];
+        }
+    }
+
+    // Returns the value with the given 0-based rank; rank must be below the total count
+    unsigned char select(uint32_t rank) const {
+        uint32_t below = 0;
+        int bin = 0;
+        while (below + coarse[bin] <= rank) {
+            below += coarse[bin];
+            ++bin;
+        }
+        int value = bin << 4;
+        while (below + fine[value] <= rank) {
+            below += fine[value];
+            ++value;
+        }
+        return static_cast<unsigned char>(value);
+    }
+};
+
+#endif // RANKHISTOGRAM_H
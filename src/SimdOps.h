@@ -0,0 +1,429 @@
+/**
+ * @file SimdOps.h
+ *
+ * @brief Vectorised row kernels shared by the projection and filter code.
+ *
+ * Each kernel works on plain byte rows and is implemented with SSE2 (16 bytes per step)
+ * on every x86-64 build and a scalar loop elsewhere; the simplest kernels also have an
+ * AVX2 path (32 bytes per step) used when the compiler targets it. The table lookup needs SSSE3:
+ * it is compiled in directly when the compiler targets SSSE3, and otherwise, with GCC or Clang on
+ * x86, built for SSSE3 alone and chosen at run time if the CPU supports it. The scalar loop also
+ * handles the tail of every row, so no kernel requires padded or aligned buffers.
+ *
+ * Usage:
+ *   SimdOps::maxBytes(maxRow, sliceRow, length);       // maxRow[i] = max(maxRow[i], sliceRow[i])
+ *   SimdOps::accumulateBytes(sumRow, sliceRow, length); // sumRow[i] += sliceRow[i]
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef SIMDOPS_H
+#define SIMDOPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIMDOPS_SSE2 1
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define SIMDOPS_SSSE3 1
+#define SIMDOPS_SSSE3_TARGET
+#elif defined(SIMDOPS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#include <tmmintrin.h>
+#define SIMDOPS_SSSE3_DISPATCH 1
+#define SIMDOPS_SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+
+class SimdOps {
+public:
+    // out[i] = (sum over t of weights[t] * rows[t][i] + rounding) >> shift, saturated to int16.
+    // Used for fixed-point separable filters: rows can be shifted views of one padded row (a
+    // horizontal pass) or several rows of a ring buffer (a vertical pass).
+    static void convolveRows16(const int16_t* const* rows, const int16_t* weights, int taps,
+                               std::size_t length, int shift, int16_t* out) {
+        convolveRows(rows, weights, taps, length, shift, out);
+    }
+
+    // Same as convolveRows16 but saturates the results to unsigned bytes.
+    static void convolveRows16To8(const int16_t* const* rows, const int16_t* weights, int taps,
+                                  std::size_t length, int shift, unsigned char* out) {
+        convolveRows(rows, weights, taps, length, shift, out);
+    }
+
+    // accumulator[i] = max(accumulator[i], row[i]) for i in [0, length)
+    static void maxBytes(unsigned char* accumulator, const unsigned char* row, std::size_t length) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= length; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+            __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulator + i), _mm256_max_epu8(a, r));
+        }
+#endif
+#if defined(SIMDOPS_SSE2)
+        for (; i + 16 <= length; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulator + i), _mm_max_epu8(a, r));
+        }
+#endif
+        for (; i < length; ++i) {
+            if (row[i] > accumulator[i]) {
+                accumulator[i] = row[i];
+            }
+        }
+    }
+
+    // accumulator[i] = min(accumulator[i], row[i]) for i in [0, length)
+    static void minBytes(unsigned char* accumulator, const unsigned char* row, std::size_t length) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= length; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+            __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulator + i), _mm256_min_epu8(a, r));
+        }
+#endif
+#if defined(SIMDOPS_SSE2)
+        for (; i + 16 <= length; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulator + i), _mm_min_epu8(a, r));
+        }
+#endif
+        for (; i < length; ++i) {
+            if (row[i] < accumulator[i]) {
+                accumulator[i] = row[i];
+            }
+        }
+    }
+
+    // data[i] = mask[i] ? values[i] : data[i] for i in [0, length); mask bytes are 0 or 0xFF
+    static void blendBytes(unsigned char* data, const unsigned char* values, const unsigned char* mask,
+                           std::size_t length) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= length; i += 32) {
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_blendv_epi8(d, v, m));
+        }
+#endif
+#if defined(SIMDOPS_SSE2)
+        for (; i + 16 <= length; i += 16) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i),
+                             _mm_or_si128(_mm_and_si128(m, v), _mm_andnot_si128(m, d)));
+        }
+#endif
+        for (; i < length; ++i) {
+            data[i] = static_cast<unsigned char>((mask[i] & values[i]) | (~mask[i] & data[i]));
+        }
+    }
+
+    // accumulator[i] += row[i] for i in [0, length), widening each byte to 32 bits
+    static void accumulateBytes(uint32_t* accumulator, const unsigned char* row, std::size_t length) {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= length; i += 32) {
+            __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            // Widen in 128-bit halves so the 32-bit results stay in source order
+            __m128i halves[2] = { _mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1) };
+            for (int h = 0; h < 2; ++h) {
+                __m256i lo = _mm256_cvtepu8_epi32(halves[h]);
+                __m256i hi = _mm256_cvtepu8_epi32(_mm_srli_si128(halves[h], 8));
+                __m256i* out = reinterpret_cast<__m256i*>(accumulator + i + h * 16);
+                _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), lo));
+                _mm256_storeu_si256(out + 1, _mm256_add_epi32(_mm256_loadu_si256(out + 1), hi));
+            }
+        }
+#endif
+#if defined(SIMDOPS_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= length; i += 16) {
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i lo16 = _mm_unpacklo_epi8(r, zero);
+            __m128i hi16 = _mm_unpackhi_epi8(r, zero);
+            __m128i widened[4] = {
+                _mm_unpacklo_epi16(lo16, zero), _mm_unpackhi_epi16(lo16, zero),
+                _mm_unpacklo_epi16(hi16, zero), _mm_unpackhi_epi16(hi16, zero)
+            };
+            __m128i* out = reinterpret_cast<__m128i*>(accumulator + i);
+            for (int q = 0; q < 4; ++q) {
+                _mm_storeu_si128(out + q, _mm_add_epi32(_mm_loadu_si128(out + q), widened[q]));
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            accumulator[i] += row[i];
+        }
+    }
+
+    // accumulator[i] -= row[i] for i in [0, length), widening each byte to 32 bits
+    static void subtractBytes(uint32_t* accumulator, const unsigned char* row, std::size_t length) {
+        std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= length; i += 16) {
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i lo16 = _mm_unpacklo_epi8(r, zero);
+            __m128i hi16 = _mm_unpackhi_epi8(r, zero);
+            __m128i widened[4] = {
+                _mm_unpacklo_epi16(lo16, zero), _mm_unpackhi_epi16(lo16, zero),
+                _mm_unpacklo_epi16(hi16, zero), _mm_unpackhi_epi16(hi16, zero)
+            };
+            __m128i* out = reinterpret_cast<__m128i*>(accumulator + i);
+            for (int q = 0; q < 4; ++q) {
+                _mm_storeu_si128(out + q, _mm_sub_epi32(_mm_loadu_si128(out + q), widened[q]));
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            accumulator[i] -= row[i];
+        }
+    }
+
+    // accumulator[i] += row[i]^2 for i in [0, length); 255^2 fits in 16 bits before widening
+    static void accumulateSquares(uint32_t* accumulator, const unsigned char* row, std::size_t length) {
+        std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= length; i += 16) {
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i lo16 = _mm_unpacklo_epi8(r, zero);
+            __m128i hi16 = _mm_unpackhi_epi8(r, zero);
+            lo16 = _mm_mullo_epi16(lo16, lo16);
+            hi16 = _mm_mullo_epi16(hi16, hi16);
+            __m128i widened[4] = {
+                _mm_unpacklo_epi16(lo16, zero), _mm_unpackhi_epi16(lo16, zero),
+                _mm_unpacklo_epi16(hi16, zero), _mm_unpackhi_epi16(hi16, zero)
+            };
+            __m128i* out = reinterpret_cast<__m128i*>(accumulator + i);
+            for (int q = 0; q < 4; ++q) {
+                _mm_storeu_si128(out + q, _mm_add_epi32(_mm_loadu_si128(out + q), widened[q]));
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            accumulator[i] += static_cast<uint32_t>(row[i]) * row[i];
+        }
+    }
+
+    // Like maxBytes, and also sets index[i] = z wherever row[i] is strictly greater than
+    // accumulator[i], so index keeps the first position of the maximum.
+    static void maxBytesWithIndex(unsigned char* accumulator, int32_t* index, const unsigned char* row,
+                                  std::size_t length, int32_t z) {
+        std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+        const __m128i position = _mm_set1_epi32(z);
+        for (; i + 16 <= length; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+            __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i larger = _mm_max_epu8(a, r);
+            __m128i keep = _mm_cmpeq_epi8(larger, a); // 0xFF where row[i] <= accumulator[i]
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulator + i), larger);
+
+            // Widen the byte mask to one 32-bit mask per index
+            __m128i keep16[2] = { _mm_unpacklo_epi8(keep, keep), _mm_unpackhi_epi8(keep, keep) };
+            __m128i* out = reinterpret_cast<__m128i*>(index + i);
+            for (int q = 0; q < 4; ++q) {
+                __m128i keep32 = (q & 1) ? _mm_unpackhi_epi16(keep16[q >> 1], keep16[q >> 1])
+                                         : _mm_unpacklo_epi16(keep16[q >> 1], keep16[q >> 1]);
+                __m128i current = _mm_loadu_si128(out + q);
+                _mm_storeu_si128(out + q, _mm_or_si128(_mm_and_si128(keep32, current),
+                                                       _mm_andnot_si128(keep32, position)));
+            }
+        }
+#endif
+        for (; i < length; ++i) {
+            if (row[i] > accumulator[i]) {
+                accumulator[i] = row[i];
+                index[i] = z;
+            }
+        }
+    }
+
+    // data[i] = table[data[i]] for i in [0, length), with a 256-entry table. When keepStride is 2
+    // or 4, bytes whose index is keepStride - 1 modulo keepStride (the alpha channel of
+    // interleaved pixels) are left unchanged. The SIMD path needs SSSE3 (pshufb); AVX2 doubles its width.
+    static void lookupBytes(unsigned char* data, std::size_t length, const unsigned char* table, int keepStride = 0) {
+        std::size_t i = 0;
+        if (hasShuffleLookup()) {
+            i = lookupBytesShuffle(data, length, table, keepStride);
+        }
+        if (keepStride == 2 || keepStride == 4) {
+            // i is a multiple of 16 here, so it starts a pixel; a partial last pixel has no alpha
+            for (; i + keepStride <= length; i += keepStride) {
+                for (int c = 0; c < keepStride - 1; ++c) {
+                    data[i + c] = table[data[i + c]];
+                }
+            }
+        }
+        for (; i < length; ++i) {
+            data[i] = table[data[i]];
+        }
+    }
+
+    // Whether lookupBytes runs its pshufb path on this build and CPU.
+    static bool hasShuffleLookup() {
+#if defined(SIMDOPS_SSSE3)
+        return true;
+#elif defined(SIMDOPS_SSSE3_DISPATCH)
+        static const bool supported = __builtin_cpu_supports("ssse3");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+private:
+    // The pshufb part of lookupBytes: maps whole 16-byte (or 32-byte) blocks and returns the
+    // number of bytes done, always a multiple of 16. Only called when hasShuffleLookup() holds.
+    SIMDOPS_SSSE3_TARGET
+    static std::size_t lookupBytesShuffle(unsigned char* data, std::size_t length, const unsigned char* table,
+                                          int keepStride) {
+        std::size_t i = 0;
+#if defined(SIMDOPS_SSSE3) || defined(SIMDOPS_SSSE3_DISPATCH)
+        // pshufb looks up 16 entries, or gives 0 where the index has its top bit set. Within each
+        // half of the table, slice k is stored XOR-ed with slice k - 1 and looked up at x - 16k:
+        // the slices up to x / 16 answer and the rest give 0, so the XOR of the eight lookups
+        // telescopes to table[x]. Signed saturation keeps x >= 128 negative in the lower half;
+        // the upper half looks up x ^ 0x80 the same way.
+        __m128i slices[16];
+        for (int k = 0; k < 16; ++k) {
+            slices[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k));
+        }
+        for (int k = 15; k >= 0; --k) {
+            if (k % 8 != 0) {
+                slices[k] = _mm_xor_si128(slices[k], slices[k - 1]);
+            }
+        }
+        alignas(16) unsigned char keepBytes[16] = {};
+        if (keepStride == 2 || keepStride == 4) {
+            for (int b = keepStride - 1; b < 16; b += keepStride) {
+                keepBytes[b] = 0xFF;
+            }
+        }
+        const __m128i keep = _mm_load_si128(reinterpret_cast<const __m128i*>(keepBytes));
+        const __m128i step = _mm_set1_epi8(16);
+        const __m128i topBit = _mm_set1_epi8(static_cast<char>(0x80));
+#if defined(__AVX2__)
+        {
+            __m256i wideSlices[16];
+            for (int k = 0; k < 16; ++k) {
+                wideSlices[k] = _mm256_broadcastsi128_si256(slices[k]);
+            }
+            const __m256i wideKeep = _mm256_broadcastsi128_si256(keep);
+            const __m256i wideStep = _mm256_set1_epi8(16);
+            const __m256i wideTopBit = _mm256_set1_epi8(static_cast<char>(0x80));
+            for (; i + 32 <= length; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i low = x;
+                __m256i high = _mm256_xor_si256(x, wideTopBit);
+                __m256i result = _mm256_setzero_si256();
+                for (int k = 0; k < 8; ++k) {
+                    result = _mm256_xor_si256(result, _mm256_xor_si256(_mm256_shuffle_epi8(wideSlices[k], low),
+                                                                       _mm256_shuffle_epi8(wideSlices[k + 8], high)));
+                    low = _mm256_subs_epi8(low, wideStep);
+                    high = _mm256_subs_epi8(high, wideStep);
+                }
+                result = _mm256_blendv_epi8(result, x, wideKeep);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), result);
+            }
+        }
+#endif
+        for (; i + 16 <= length; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i low = x;
+            __m128i high = _mm_xor_si128(x, topBit);
+            __m128i result = _mm_setzero_si128();
+            for (int k = 0; k < 8; ++k) {
+                result = _mm_xor_si128(result, _mm_xor_si128(_mm_shuffle_epi8(slices[k], low),
+                                                             _mm_shuffle_epi8(slices[k + 8], high)));
+                low = _mm_subs_epi8(low, step);
+                high = _mm_subs_epi8(high, step);
+            }
+            result = _mm_or_si128(_mm_and_si128(keep, x), _mm_andnot_si128(keep, result));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), result);
+        }
+#else
+        (void)data, (void)length, (void)table, (void)keepStride;
+#endif
+        return i;
+    }
+
+#if defined(SIMDOPS_SSE2)
+    static void store8(int16_t* out, __m128i sums16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), sums16);
+    }
+    static void store8(unsigned char* out, __m128i sums16) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(sums16, sums16));
+    }
+#endif
+    static void storeScalar(int16_t* out, int32_t value) {
+        *out = static_cast<int16_t>(value < -32768 ? -32768 : (value > 32767 ? 32767 : value));
+    }
+    static void storeScalar(unsigned char* out, int32_t value) {
+        *out = static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+
+    template <typename Out>
+    static void convolveRows(const int16_t* const* rows, const int16_t* weights, int taps,
+                             std::size_t length, int shift, Out* out) {
+        const int32_t rounding = shift > 0 ? 1 << (shift - 1) : 0;
+        std::size_t i = 0;
+#if defined(SIMDOPS_SSE2)
+        // Taps are taken in pairs: interleaving two rows lets _mm_madd_epi16 apply both weights
+        // and add the products in one instruction. An odd last tap is paired with zeros. The
+        // broadcast weights live on the stack, so kernels wider than 2 * maxPairs taps (far beyond
+        // any useful Gaussian) take the scalar loop instead.
+        constexpr int maxPairs = 32;
+        int pairs = (taps + 1) / 2;
+        __m128i weightPairs[maxPairs];
+        for (int p = 0; p < pairs && p < maxPairs; ++p) {
+            uint16_t first = static_cast<uint16_t>(weights[2 * p]);
+            uint16_t second = 2 * p + 1 < taps ? static_cast<uint16_t>(weights[2 * p + 1]) : 0;
+            weightPairs[p] = _mm_set1_epi32(static_cast<int32_t>(first | (static_cast<uint32_t>(second) << 16)));
+        }
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi32(rounding);
+        const __m128i count = _mm_cvtsi32_si128(shift);
+        int fullPairs = taps / 2;
+        for (; pairs <= maxPairs && i + 8 <= length; i += 8) {
+            __m128i lo = round, hi = round;
+            for (int p = 0; p < fullPairs; ++p) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[2 * p] + i));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[2 * p + 1] + i));
+                lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), weightPairs[p]));
+                hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), weightPairs[p]));
+            }
+            if (fullPairs < pairs) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[taps - 1] + i));
+                lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), weightPairs[fullPairs]));
+                hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), weightPairs[fullPairs]));
+            }
+            store8(out + i, _mm_packs_epi32(_mm_sra_epi32(lo, count), _mm_sra_epi32(hi, count)));
+        }
+#endif
+        for (; i < length; ++i) {
+            int32_t sum = rounding;
+            for (int t = 0; t < taps; ++t) {
+                sum += static_cast<int32_t>(weights[t]) * rows[t][i];
+            }
+            storeScalar(out + i, sum >> shift);
+        }
+    }
+};
+
+#endif // SIMDOPS_H
@@ -0,0 +1,196 @@
+/**
+ * @file SlabIndex.cpp
+ *
+ * @brief Implements the SlabIndex class: z prefix sums and max/min pyramids over a volume.
+ *
+ * Building and querying both sweep the slice area in chunks on worker threads. A chunk is carried
+ * through every slice (or pyramid level) before the next chunk starts, so its working set stays in
+ * cache. A pyramid query walks the levels bottom-up like a segment tree: at each level at most one
+ * block is taken from each end of the remaining range before both ends move up a level.
+ *
+ * Dependencies:
+ *   - SlabIndex.h for the declaration of the SlabIndex class.
+ *   - SimdOps.h for the vectorised max and min row kernels.
+ *   - Parallel.h for processing chunks on worker threads.
+ *   - Standard libraries: <algorithm> and <cstring>.
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+#include "SlabIndex.h"
+#include "SimdOps.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstring>
+
+// Bytes of one slice handled by one task, matching the projection chunks
+static const std::size_t slabChunkBytes = 16 * 1024;
+
+/**
+ * @brief Builds the prefix sums and/or pyramids of a volume.
+ *
+ * @param volume The volume to summarise.
+ * @param buildSums Whether to build the z prefix sums used by average().
+ * @param buildExtrema Whether to build the max and min pyramids used by maximum() and minimum().
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+SlabIndex::SlabIndex(const Volume& volume, bool buildSums, bool buildExtrema, int threadCount)
+    : width(volume.getWidth()), height(volume.getHeight()), depth(volume.getDepth()),
+      channels(volume.getChannels()), sliceBytes(volume.getZStride()),
+      withSums(buildSums), withExtrema(buildExtrema) {
+    const unsigned char* allData = volume.getData();
+    if (withSums) {
+        prefixSums.resize(sliceBytes * depth);
+    }
+    if (withExtrema) {
+        for (int level = 1; (depth >> level) > 0; ++level) {
+            maxLevels.emplace_back(sliceBytes * (depth >> level));
+            minLevels.emplace_back(sliceBytes * (depth >> level));
+        }
+    }
+
+    Parallel::parallelForChunks(sliceBytes, slabChunkBytes, [&](std::size_t offset, std::size_t length) {
+        if (withSums) {
+            const uint32_t* previous = nullptr;
+            for (int z = 0; z < depth; ++z) {
+                const unsigned char* row = allData + z * sliceBytes + offset;
+                uint32_t* sums = prefixSums.data() + z * sliceBytes + offset;
+                for (std::size_t i = 0; i < length; ++i) {
+                    sums[i] = (previous ? previous[i] : 0) + row[i];
+                }
+                previous = sums;
+            }
+        }
+
+        // Block i of level l combines blocks 2i and 2i + 1 of level l - 1 (level 0 is the volume)
+        for (std::size_t level = 0; level < maxLevels.size(); ++level) {
+            const unsigned char* maxBelow = level == 0 ? allData : maxLevels[level - 1].data();
+            const unsigned char* minBelow = level == 0 ? allData : minLevels[level - 1].data();
+            int blocks = depth >> (level + 1);
+            for (int block = 0; block < blocks; ++block) {
+                std::size_t first = (2 * block) * sliceBytes + offset, second = first + sliceBytes;
+                unsigned char* maxRow = maxLevels[level].data() + block * sliceBytes + offset;
+                unsigned char* minRow = minLevels[level].data() + block * sliceBytes + offset;
+                std::memcpy(maxRow, maxBelow + first, length);
+                SimdOps::maxBytes(maxRow, maxBelow + second, length);
+                std::memcpy(minRow, minBelow + first, length);
+                SimdOps::minBytes(minRow, minBelow + second, length);
+            }
+        }
+    }, threadCount);
+}
+
+/**
+ * @brief Checks that a volume has the dimensions this index was built for.
+ *
+ * @param volume The volume to check.
+ * @return True if width, height, depth and channels all match.
+ */
+bool SlabIndex::matches(const Volume& volume) const {
+    return volume.getWidth() == width && volume.getHeight() == height &&
+           volume.getDepth() == depth && volume.getChannels() == channels;
+}
+
+/**
+ * @brief Computes the truncated mean of the slices [zBegin, zEnd) from the prefix sums.
+ *
+ * @param zBegin The first slice (0-based) of the slab.
+ * @param zEnd One past the last slice of the slab.
+ * @param output Receives one value per pixel and channel; all zero if the slab is empty.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void SlabIndex::average(int zBegin, int zEnd, unsigned char* output, int threadCount) const {
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, depth);
+    if (zBegin >= zEnd) {
+        std::fill(output, output + sliceBytes, 0);
+        return;
+    }
+
+    uint32_t count = static_cast<uint32_t>(zEnd - zBegin);
+    Parallel::parallelForChunks(sliceBytes, slabChunkBytes, [&](std::size_t offset, std::size_t length) {
+        const uint32_t* upper = prefixSums.data() + (zEnd - 1) * sliceBytes + offset;
+        const uint32_t* lower = zBegin > 0 ? prefixSums.data() + (zBegin - 1) * sliceBytes + offset : nullptr;
+        for (std::size_t i = 0; i < length; ++i) {
+            output[offset + i] = static_cast<unsigned char>((upper[i] - (lower ? lower[i] : 0)) / count);
+        }
+    }, threadCount);
+}
+
+/**
+ * @brief Folds the pyramid blocks that exactly cover [zBegin, zEnd) into output.
+ *
+ * @param volume The volume the index was built from (level 0 of the pyramid).
+ * @param levels The pyramid levels above level 0.
+ * @param zBegin The first slice (0-based) of the slab; must be below zEnd.
+ * @param zEnd One past the last slice of the slab.
+ * @param output Receives one value per pixel and channel.
+ * @param combine Row kernel folding a block into the output, e.g. SimdOps::maxBytes.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+template <typename Combine>
+void SlabIndex::queryPyramid(const Volume& volume, const std::vector<VoxelBuffer>& levels, int zBegin, int zEnd,
+                             unsigned char* output, Combine combine, int threadCount) const {
+    Parallel::parallelForChunks(sliceBytes, slabChunkBytes, [&](std::size_t offset, std::size_t length) {
+        bool first = true;
+        auto fold = [&](const unsigned char* slice) {
+            if (first) {
+                std::memcpy(output + offset, slice + offset, length);
+                first = false;
+            } else {
+                combine(output + offset, slice + offset, length);
+            }
+        };
+
+        // [low, high) are whole blocks of the current level still to be covered
+        int low = zBegin, high = zEnd;
+        for (int level = 0; low < high; ++level, low >>= 1, high >>= 1) {
+            const unsigned char* blocks = level == 0 ? volume.getData() : levels[level - 1].data();
+            if (low & 1) {
+                fold(blocks + static_cast<std::size_t>(low++) * sliceBytes);
+            }
+            if (high & 1) {
+                fold(blocks + static_cast<std::size_t>(--high) * sliceBytes);
+            }
+        }
+    }, threadCount);
+}
+
+/**
+ * @brief Computes the maximum of the slices [zBegin, zEnd) from the max pyramid.
+ *
+ * @param volume The volume the index was built from.
+ * @param zBegin The first slice (0-based) of the slab.
+ * @param zEnd One past the last slice of the slab.
+ * @param output Receives one value per pixel and channel; all zero if the slab is empty.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void SlabIndex::maximum(const Volume& volume, int zBegin, int zEnd, unsigned char* output, int threadCount) const {
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, depth);
+    if (zBegin >= zEnd) {
+        std::fill(output, output + sliceBytes, 0);
+        return;
+    }
+    queryPyramid(volume, maxLevels, zBegin, zEnd, output, SimdOps::maxBytes, threadCount);
+}
+
+/**
+ * @brief Computes the minimum of the slices [zBegin, zEnd) from the min pyramid.
+ *
+ * @param volume The volume the index was built from.
+ * @param zBegin The first slice (0-based) of the slab.
+ * @param zEnd One past the last slice of the slab.
+ * @param output Receives one value per pixel and channel; all 255 if the slab is empty.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void SlabIndex::minimum(const Volume& volume, int zBegin, int zEnd, unsigned char* output, int threadCount) const {
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, depth);
+    if (zBegin >= zEnd) {
+        std::fill(output, output + sliceBytes, 255);
+        return;
+    }
+    queryPyramid(volume, minLevels, zBegin, zEnd, output, SimdOps::minBytes, threadCount);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file SlabIndex.h
+ *
+ * @brief Precomputed per-pixel summaries of a volume that answer slab projections quickly.
+ *
+ * A SlabIndex stores, for every pixel and channel of a volume:
+ *   - z prefix sums (32-bit), so the sum over any slab [zBegin, zEnd) is one subtraction and
+ *     the AIP of a slab costs O(1) per pixel regardless of its thickness;
+ *   - a max and a min pyramid: level l holds the max (min) of aligned blocks of 2^l slices,
+ *     so the MIP (MinIP) of any slab combines at most 2 log2(depth) whole slices.
+ *
+ * The sums take four times the volume's size and each pyramid about as much as the volume.
+ * Level 0 of the pyramids is the volume itself, so queries take the volume they were built from.
+ * Slice ranges are 0-based and half-open.
+ *
+ * Usage:
+ *   auto index = std::make_shared<SlabIndex>(volume);
+ *   volume.setSlabIndex(index);
+ *   std::vector<unsigned char> mip(volume.getZStride());
+ *   index->maximum(volume, 10, 70, mip.data());
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef SLABINDEX_H
+#define SLABINDEX_H
+
+#include "Volume.h"
+#include <cstdint>
+#include <vector>
+
+class SlabIndex {
+public:
+    // Builds the summaries for volume; sums and/or extrema can be skipped to save memory.
+    explicit SlabIndex(const Volume& volume, bool buildSums = true, bool buildExtrema = true, int threadCount = 0);
+
+    bool hasSums() const { return withSums; }
+    bool hasExtrema() const { return withExtrema; }
+
+    // True if the index was built from a volume with the same dimensions.
+    bool matches(const Volume& volume) const;
+
+    // Each query writes one value per pixel and channel (volume.getZStride() bytes) to output.
+    void average(int zBegin, int zEnd, unsigned char* output, int threadCount = 0) const;
+    void maximum(const Volume& volume, int zBegin, int zEnd, unsigned char* output, int threadCount = 0) const;
+    void minimum(const Volume& volume, int zBegin, int zEnd, unsigned char* output, int threadCount = 0) const;
+
+private:
+    // Folds the pyramid blocks covering [zBegin, zEnd) into output with combine.
+    template <typename Combine>
+    void queryPyramid(const Volume& volume, const std::vector<VoxelBuffer>& levels, int zBegin, int zEnd,
+                      unsigned char* output, Combine combine, int threadCount) const;
+
+    int width, height, depth, channels;
+    std::size_t sliceBytes;
+    bool withSums, withExtrema;
+    std::vector<uint32_t, AlignedAllocator<uint32_t>> prefixSums; // slice z holds the sum of slices 0..z
+    std::vector<VoxelBuffer> maxLevels; // maxLevels[l - 1] holds floor(depth / 2^l) block maxima
+    std::vector<VoxelBuffer> minLevels;
+};
+
+#endif // SLABINDEX_H
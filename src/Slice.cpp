@@ -12,21 +12,57 @@
  * The output slices are saved as PNG files to a specified path. This implementation
  * relies on the stb_image_write library to handle the image writing process.
  *
+ * Many slices can also be extracted at once into a Volume whose slices are the requested XZ or YZ
+ * planes, and a whole volume can be permuted so that it can be re-saved along another axis. XZ
+ * slices are gathered with whole-row copies. YZ slices need a transpose of every z slice, which is
+ * done in square tiles so that both the rows read and the rows written stay in cache.
+ *
  * Dependencies:
  *   - Slice.h for the declaration of the Slice class.
  *   - stb_image_write.h for writing the slice images as PNG files.
  *   - Volume.h for accessing the volume data.
- *   - Standard libraries: <vector>, <iostream>, and <cassert>.
+ *   - Parallel.h for extracting slices on worker threads.
+ *   - Standard libraries: <vector>, <iostream>, <algorithm>, <cstring>, and <cassert>.
  * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
  *         edsml-hs1623, acse-xg1123, edsml-st2923,
  *         Group: selection sort.
  */
 #include "Slice.h"
+#include "Parallel.h"
 #include "stb_image_write.h"
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include <cassert> // For assert to validate input
 
+// Edge length, in voxels, of the square tiles used to transpose slices for YZ extraction
+static const int transposeTile = 32;
+
+/**
+ * @brief Converts 1-based slice indices to 0-based ones, or lists every index if none are given.
+ *
+ * @param indices The requested 1-based indices.
+ * @param extent The size of the volume along the sliced axis.
+ * @return The 0-based indices.
+ *
+ * @note The function asserts that every index is within the volume's bounds.
+ */
+static std::vector<int> resolveIndices(const std::vector<int>& indices, int extent) {
+    std::vector<int> resolved;
+    if (indices.empty()) {
+        for (int i = 0; i < extent; ++i) {
+            resolved.push_back(i);
+        }
+        return resolved;
+    }
+    for (int index : indices) {
+        assert(index > 0 && index <= extent); // Ensure the index is within bounds
+        resolved.push_back(index - 1);
+    }
+    return resolved;
+}
+
 /**
  * @brief Extracts and saves a slice from the given volume along the XZ plane at a specified Y index.
  *
@@ -37,28 +73,7 @@
  * @note The function asserts that the given Y index is within the volume's bounds.
  */
 void Slice::sliceXZ(const Volume& volume, int y, const std::string& outputPath) {
-    assert(y > 0 && y <= volume.getHeight()); // Ensure y is within bounds
-    int width = volume.getWidth();
-    int depth = volume.getDepth();
-    int channels = volume.getChannels();
-    std::vector<unsigned char> sliceData(width * depth * channels);
-
-    // Adjust y to 0-based index for internal use
-    y = y - 1;
-
-    const auto& allData = volume.getData(); // Correctly access all volume data once
-
-    for (int z = 0; z < depth; ++z) {
-        const auto& currentSliceData = allData[z]; // Access specific slice
-        for (int x = 0; x < width; ++x) {
-            for (int ch = 0; ch < channels; ++ch) {
-                int index = ((y * width) + x) * channels + ch;
-                sliceData[(z * width + x) * channels + ch] = currentSliceData[index]; // Corrected access
-            }
-        }
-    }
-
-    stbi_write_png(outputPath.c_str(), width, depth, channels, sliceData.data(), width * channels);
+    saveSlices(extractXZ(volume, {y}), {outputPath});
 }
 
 /**
@@ -71,26 +86,113 @@ void Slice::sliceXZ(const Volume& volume, int y, const std::string& outputPath)
  * @note The function asserts that the given X index is within the volume's bounds.
  */
 void Slice::sliceYZ(const Volume& volume, int x, const std::string& outputPath) {
-    assert(x > 0 && x <= volume.getWidth()); // Ensure x is within bounds
-    int height = volume.getHeight();
+    saveSlices(extractYZ(volume, {x}), {outputPath});
+}
+
+/**
+ * @brief Extracts several XZ slices in one pass.
+ *
+ * Each XZ slice is a stack of one row from every z slice, so it is gathered with whole-row copies.
+ *
+ * @param volume The 3D volume from which to extract the slices.
+ * @param indices The 1-based Y indices of the slices; empty for every slice.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return A volume of width x depth slices, one per requested index, with the source's channels.
+ */
+Volume Slice::extractXZ(const Volume& volume, const std::vector<int>& indices, int threadCount) {
+    std::vector<int> ys = resolveIndices(indices, volume.getHeight());
     int depth = volume.getDepth();
-    int channels = volume.getChannels();
-    std::vector<unsigned char> sliceData(height * depth * channels);
+    Volume slices(volume.getWidth(), depth, static_cast<int>(ys.size()), volume.getChannels());
+    std::size_t rowBytes = volume.getYStride();
+    const unsigned char* source = volume.getData();
+    unsigned char* target = slices.getData();
 
-    // Adjust x to 0-based index for internal use
-    x = x - 1;
+    Parallel::parallelFor(0, static_cast<int>(ys.size()), [&](int i) {
+        for (int z = 0; z < depth; ++z) {
+            std::memcpy(target + slices.index(0, z, i), source + volume.index(0, ys[i], z), rowBytes);
+        }
+    }, threadCount);
+    return slices;
+}
 
-    const auto& allData = volume.getData(); // Correctly access all volume data once
+/**
+ * @brief Extracts several YZ slices in one pass.
+ *
+ * Every z slice is read once and transposed into the requested slices in square tiles: a tile
+ * covers transposeTile rows of the source and transposeTile of the requested columns, so the
+ * strided reads of a tile hit cache lines that were just loaded, and each write is a contiguous
+ * run of transposeTile voxels in an output row.
+ *
+ * @param volume The 3D volume from which to extract the slices.
+ * @param indices The 1-based X indices of the slices; empty for every slice.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return A volume of height x depth slices, one per requested index, with the source's channels.
+ */
+Volume Slice::extractYZ(const Volume& volume, const std::vector<int>& indices, int threadCount) {
+    std::vector<int> xs = resolveIndices(indices, volume.getWidth());
+    int height = volume.getHeight();
+    int channels = volume.getChannels();
+    int count = static_cast<int>(xs.size());
+    Volume slices(height, volume.getDepth(), count, channels);
+    std::size_t rowStride = volume.getYStride();
+    const unsigned char* source = volume.getData();
+    unsigned char* target = slices.getData();
 
-    for (int z = 0; z < depth; ++z) {
-        const auto& currentSliceData = allData[z]; // Access specific slice
-        for (int y = 0; y < height; ++y) {
-            for (int ch = 0; ch < channels; ++ch) {
-                int index = (y * volume.getWidth() + x) * channels + ch;
-                sliceData[(z * height + y) * channels + ch] = currentSliceData[index]; // Corrected access
+    Parallel::parallelFor(0, volume.getDepth(), [&](int z) {
+        for (int y0 = 0; y0 < height; y0 += transposeTile) {
+            int y1 = std::min(y0 + transposeTile, height);
+            for (int i0 = 0; i0 < count; i0 += transposeTile) {
+                int i1 = std::min(i0 + transposeTile, count);
+                for (int i = i0; i < i1; ++i) {
+                    const unsigned char* column = source + volume.index(xs[i], 0, z);
+                    unsigned char* row = target + slices.index(0, z, i);
+                    if (channels == 1) {
+                        for (int y = y0; y < y1; ++y) {
+                            row[y] = column[y * rowStride];
+                        }
+                        continue;
+                    }
+                    for (int y = y0; y < y1; ++y) {
+                        for (int ch = 0; ch < channels; ++ch) {
+                            row[y * channels + ch] = column[y * rowStride + ch];
+                        }
+                    }
+                }
             }
         }
-    }
+    }, threadCount);
+    return slices;
+}
 
-    stbi_write_png(outputPath.c_str(), height, depth, channels, sliceData.data(), height * channels);
+/**
+ * @brief Reorders the axes of a volume.
+ *
+ * XZY stacks every XZ slice and YZX every YZ slice, so saving the result with saveVolume()
+ * writes the volume out along the Y or X axis instead of Z.
+ *
+ * @param volume The 3D volume to permute.
+ * @param order The axis order of the result.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @return The permuted volume.
+ */
+Volume Slice::permute(const Volume& volume, AxisOrder order, int threadCount) {
+    if (order == XZY) {
+        return extractXZ(volume, {}, threadCount);
+    }
+    return extractYZ(volume, {}, threadCount);
 }
+
+/**
+ * @brief Saves every slice of a volume as a PNG file.
+ *
+ * @param slices The volume whose slices are saved, e.g. the result of extractXZ or extractYZ.
+ * @param outputPaths One output path per slice.
+ */
+void Slice::saveSlices(const Volume& slices, const std::vector<std::string>& outputPaths) {
+    int width = slices.getWidth();
+    int channels = slices.getChannels();
+    int count = std::min(slices.getDepth(), static_cast<int>(outputPaths.size()));
+    Parallel::parallelFor(0, count, [&](int i) {
+        stbi_write_png(outputPaths[i].c_str(), width, slices.getHeight(), channels, slices.getSlice(i).data, width * channels);
+    });
+}
\ No newline at end of file
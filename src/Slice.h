@@ -9,11 +9,29 @@
 
 #include "Volume.h"
 #include <string>
+#include <vector>
+
+// Axis order of a permuted volume, fastest-varying axis first (the original is XYZ).
+enum AxisOrder {
+    XZY, // slice k is the XZ slice at y = k; rows are z
+    YZX  // slice k is the YZ slice at x = k; rows are z
+};
 
 class Slice {
 public:
     static void sliceXZ(const Volume& volume, int y, const std::string& outputPath);
     static void sliceYZ(const Volume& volume, int x, const std::string& outputPath);
+
+    // Reorders the axes of a whole volume; saveVolume() on the result re-saves it along the new axis.
+    static Volume permute(const Volume& volume, AxisOrder order, int threadCount = 0);
+
+    // Extracts several slices in one pass over the volume. Slice i of the result is the XZ (YZ)
+    // slice at the 1-based index indices[i]; an empty list extracts every slice.
+    static Volume extractXZ(const Volume& volume, const std::vector<int>& indices, int threadCount = 0);
+    static Volume extractYZ(const Volume& volume, const std::vector<int>& indices, int threadCount = 0);
+
+    // Saves slice i of a volume to outputPaths[i] as a PNG file.
+    static void saveSlices(const Volume& slices, const std::vector<std::string>& outputPaths);
 };
 
 #endif // SLICE_H
\ No newline at end of file
@@ -0,0 +1,108 @@
+/**
+ * @file SummedAreaTable.h
+ *
+ * @brief Summed-area tables (integral images) for constant-time rectangle sums over an Image.
+ *
+ * Entry (x, y, c) of the table holds the sum of channel c over every pixel above and to the left
+ * of (x, y), exclusive, so the table has one extra row and column of zeros and the sum over any
+ * rectangle is four lookups. A table can hold the pixel values or their squares, which together
+ * give the local mean and variance needed by adaptive filters and thresholds.
+ *
+ * The accumulator type T only has to hold the sum over one queried rectangle, not over the whole
+ * image: the table entries may wrap around, but unsigned arithmetic is modular, so the four-term
+ * difference is still exact. A 32-bit table therefore answers value sums over rectangles of up to
+ * 2^32 / 255 (about 16.8 million) pixels at any image size; squares need 64 bits for rectangles
+ * larger than about 66 thousand pixels.
+ *
+ * Usage:
+ *   IntegralImage sums(image);
+ *   IntegralImage64 squares(image, true);
+ *   uint32_t total = sums.sum(x0, y0, x1, y1, c); // pixels x0 <= x < x1, y0 <= y < y1
+ *
+ * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
+ *         edsml-hs1623, acse-xg1123, edsml-st2923,
+ *         Group: selection sort.
+ */
+
+#ifndef SUMMEDAREATABLE_H
+#define SUMMEDAREATABLE_H
+
+#include "Image.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class SummedAreaTable {
+    static_assert(std::is_unsigned<T>::value, "SummedAreaTable relies on modular unsigned arithmetic");
+
+public:
+    SummedAreaTable() : width(0), height(0), channels(0) {}
+
+    // Builds the table of pixel values, or of their squares if squared is true.
+    explicit SummedAreaTable(const Image& image, bool squared = false)
+        : SummedAreaTable(image.getData(), image.getWidth(), image.getHeight(), image.getChannels(), squared) {}
+
+    // Builds the table from interleaved 8-bit data with the given dimensions.
+    SummedAreaTable(const unsigned char* data, int width, int height, int channels, bool squared = false)
+        : width(width), height(height), channels(channels),
+          table(static_cast<std::size_t>(width + 1) * (height + 1) * channels, 0) {
+        std::size_t stride = rowStride();
+        std::vector<T> rowSums(channels);
+        for (int y = 0; y < height; ++y) {
+            const unsigned char* row = data + static_cast<std::size_t>(y) * width * channels;
+            const T* above = table.data() + y * stride;
+            T* current = table.data() + (y + 1) * stride;
+            std::fill(rowSums.begin(), rowSums.end(), 0);
+            for (int x = 0; x < width; ++x) {
+                for (int c = 0; c < channels; ++c) {
+                    T value = row[x * channels + c];
+                    rowSums[c] += squared ? value * value : value;
+                    std::size_t i = static_cast<std::size_t>(x + 1) * channels + c;
+                    current[i] = above[i] + rowSums[c];
+                }
+            }
+        }
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChannels() const { return channels; }
+
+    // Sum of channel c over pixels x0 <= x < x1, y0 <= y < y1; the rectangle must lie inside the image.
+    T sum(int x0, int y0, int x1, int y1, int c) const {
+        std::size_t stride = rowStride();
+        const T* top = table.data() + y0 * stride + c;
+        const T* bottom = table.data() + y1 * stride + c;
+        return bottom[x1 * channels] - bottom[x0 * channels] - top[x1 * channels] + top[x0 * channels];
+    }
+
+    // Like sum(), but the rectangle is clipped to the image first; count receives the clipped area.
+    T clippedSum(int x0, int y0, int x1, int y1, int c, int& count) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, width);
+        y1 = std::min(y1, height);
+        if (x0 >= x1 || y0 >= y1) {
+            count = 0;
+            return 0;
+        }
+        count = (x1 - x0) * (y1 - y0);
+        return sum(x0, y0, x1, y1, c);
+    }
+
+private:
+    std::size_t rowStride() const { return static_cast<std::size_t>(width + 1) * channels; }
+
+    int width, height, channels;
+    std::vector<T> table; // (height + 1) rows of (width + 1) * channels entries
+};
+
+// Value sums over rectangles of up to about 16.8 million pixels.
+using IntegralImage = SummedAreaTable<uint32_t>;
+// Sums of squares, or value sums over larger rectangles.
+using IntegralImage64 = SummedAreaTable<uint64_t>;
+
+#endif // SUMMEDAREATABLE_H
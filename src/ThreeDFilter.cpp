@@ -5,14 +5,15 @@
  *
  * This file provides the implementation of various 3D image processing techniques, primarily focusing on
  * Gaussian and Median blur filters. These filters are applied to Volume objects representing 3D images or data sets.
- * The Gaussian blur is implemented by convolving the image with a Gaussian kernel, while the Median blur is
+ * The Gaussian blur is implemented as three separable 1D convolutions along x, y and z, while the Median blur is
  * realized through a non-linear filtering approach that replaces each voxel's intensity with the median
  * of intensities in its neighborhood.
  *
  * Key Functionalities:
  *   - Gaussian Blur: Applies a Gaussian blur filter to smooth 3D images, useful for reducing image noise and details.
- *   - Median Blur: Applies a Median blur filter to reduce noise without creating artifacts.
+ *   - Median Blur: Applies an exact Median blur filter, using sliding histograms, to reduce noise without creating artifacts.
  *   - Utility Functions: Includes functions for value clamping and kernel generation.
+ *   - Multi-threading: Both filters split the volume into z-slabs processed on a thread pool.
  *
  * Usage:
  *   Volume myVolume;
@@ -26,16 +27,21 @@
  * Dependencies:
  *   - Volume.h for the Volume class definition and manipulation.
  *   - <cmath> and <vector> for mathematical operations and data storage.
- *   - <numeric> and <array> for additional array operations and fixed-size array storage.
+ *   - RankHistogram.h for the sliding histograms used by the median blur.
+ *   - MedianNetwork.h for the vectorised 3x3x3 median.
+ *   - Parallel.h for processing z-slabs of the volume on worker threads.
  * @author acse-yw3523,edsml-lwk16, acse-ad2123, 
  *         edsml-hs1623, acse-xg1123, edsml-st2923,
  *         Group: selection sort.
  */
 #include "ThreeDFilter.h"
+#include "MedianNetwork.h"
+#include "RankHistogram.h"
+#include "Parallel.h"
 #include <cmath>
 #include <vector>
-#include <numeric>
-#include <array>
+#include <algorithm>
+#include <utility>
 
 template <typename T>
 T clamp(T val, T minVal, T maxVal) {
@@ -45,301 +51,361 @@ T clamp(T val, T minVal, T maxVal) {
 }
 
 /**
- * @brief Calculates the Gaussian value for a given point and sigma.
- * @param x The x-coordinate of the point.
- * @param y The y-coordinate of the point.
- * @param z The z-coordinate of the point.
+ * @brief Builds a normalised 1D Gaussian kernel.
+ *
+ * The 3D Gaussian is the product of three 1D Gaussians, so the normalised k x k x k kernel
+ * equals the outer product of this kernel with itself along x, y and z.
+ * @param kernelSize The size of the kernel (must be an odd number).
  * @param sigma The standard deviation of the Gaussian distribution.
- * @return The Gaussian function value at the given point.
+ * @return The kernelSize weights, summing to 1.
  */
-float ThreeDFilter::gaussian(float x, float y, float z, float sigma) {
-    return std::exp(-(x * x + y * y + z * z) / (2 * sigma * sigma)) / (std::sqrt(2 * M_PI) * sigma);
+std::vector<float> ThreeDFilter::gaussianKernel1D(int kernelSize, float sigma) {
+    int halfSize = kernelSize / 2;
+    std::vector<float> kernel(kernelSize);
+    float kernelSum = 0;
+    for (int i = -halfSize; i <= halfSize; i++) {
+        float value = std::exp(-(i * i) / (2 * sigma * sigma));
+        kernel[i + halfSize] = value;
+        kernelSum += value;
+    }
+
+    // Normalize the kernel
+    for (auto& value : kernel) {
+        value /= kernelSum;
+    }
+    return kernel;
 }
 
 /**
- * @brief Applies a Gaussian blur to a given volume.
- * @param volume A reference to the Volume object to blur.
- * @param kernelSize The size of the Gaussian kernel (must be an odd number).
- * @param sigma The standard deviation of the Gaussian distribution used for the kernel.
+ * @brief Blurs one slice in x and y into a float plane.
+ *
+ * The x pass reads each row once into a float line buffer whose borders are replicated,
+ * so the taps need no bounds checks. The y pass combines whole rows, clamping the row
+ * index once per row rather than once per tap.
+ * @param volume The source volume.
+ * @param z The 0-based index of the slice to blur.
+ * @param kernel The normalised 1D kernel.
+ * @param rowsX Scratch plane receiving the x-blurred slice.
+ * @param line Scratch line buffer of (width + kernelSize - 1) * channels floats.
+ * @param plane Output plane receiving the xy-blurred slice.
  */
-void ThreeDFilter::gaussianBlur(Volume& volume, int kernelSize, float sigma) {
+void ThreeDFilter::blurSliceXY(const Volume& volume, int z, const std::vector<float>& kernel,
+                               float* rowsX, float* line, float* plane) {
     int width = volume.getWidth();
     int height = volume.getHeight();
-    int depth = volume.getDepth();
     int channels = volume.getChannels();
-
-    // Preparing the Gaussian kernel
+    int kernelSize = static_cast<int>(kernel.size());
     int halfSize = kernelSize / 2;
-    std::vector<float> kernel(kernelSize * kernelSize * kernelSize);
-    float kernelSum = 0;
-    for (int x = -halfSize; x <= halfSize; x++) {
-        for (int y = -halfSize; y <= halfSize; y++) {
-            for (int z = -halfSize; z <= halfSize; z++) {
-                float value = gaussian(x, y, z, sigma);
-                kernel[(x + halfSize) * kernelSize * kernelSize + (y + halfSize) * kernelSize + (z + halfSize)] = value;
-                kernelSum += value;
+    int rowLength = width * channels;
+    SliceView<const unsigned char> slice = volume.getSlice(z);
+
+    // X pass: pad the row once, then every tap is a plain offset into the line buffer
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = slice.row(y);
+        for (int x = -halfSize; x < width + halfSize; x++) {
+            const unsigned char* pixel = row + clamp(x, 0, width - 1) * channels;
+            for (int ch = 0; ch < channels; ch++) {
+                line[(x + halfSize) * channels + ch] = pixel[ch];
             }
         }
+        float* out = rowsX + static_cast<size_t>(y) * rowLength;
+        for (int i = 0; i < rowLength; i++) {
+            float sum = 0;
+            for (int k = 0; k < kernelSize; k++) {
+                sum += line[i + k * channels] * kernel[k];
+            }
+            out[i] = sum;
+        }
     }
 
-    // Normalize the kernel
-    for (auto& value : kernel) {
-        value /= kernelSum;
-    }
-
-    std::vector<std::vector<unsigned char>> newVolumeData(depth, std::vector<unsigned char>(width * height * channels));
-
-    // Apply Gaussian Blur
-    for (int z = 0; z < depth; z++) {
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                for (int ch = 0; ch < channels; ch++) {
-                    float blurredPixel = 0;
-                    for (int kx = -halfSize; kx <= halfSize; kx++) {
-                        for (int ky = -halfSize; ky <= halfSize; ky++) {
-                            for (int kz = -halfSize; kz <= halfSize; kz++) {
-                                int xx = std::min(std::max(x + kx, 0), width - 1);
-                                int yy = std::min(std::max(y + ky, 0), height - 1);
-                                int zz = std::min(std::max(z + kz, 0), depth - 1);
-                                blurredPixel += volume.getData()[zz][((yy * width + xx) * channels) + ch] * kernel[(kx + halfSize) * kernelSize * kernelSize + (ky + halfSize) * kernelSize + (kz + halfSize)];
-                            }
-                        }
-                    }
-                    newVolumeData[z][((y * width + x) * channels) + ch] = std::min(std::max(int(blurredPixel), 0), 255);
-                }
+    // Y pass: weighted sum of whole rows, borders clamped per row
+    for (int y = 0; y < height; y++) {
+        float* out = plane + static_cast<size_t>(y) * rowLength;
+        const float* first = rowsX + static_cast<size_t>(clamp(y - halfSize, 0, height - 1)) * rowLength;
+        for (int i = 0; i < rowLength; i++) {
+            out[i] = first[i] * kernel[0];
+        }
+        for (int k = 1; k < kernelSize; k++) {
+            const float* in = rowsX + static_cast<size_t>(clamp(y + k - halfSize, 0, height - 1)) * rowLength;
+            float weight = kernel[k];
+            for (int i = 0; i < rowLength; i++) {
+                out[i] += in[i] * weight;
             }
         }
     }
-
-    volume.setData(newVolumeData);
 }
 
-//Optimized version of Gaussian Blur
-// std::vector<float> ThreeDFilter::precomputeGaussianKernel(int kernelSize, float sigma) {
-//     std::vector<float> kernel(kernelSize);
-//     int halfSize = kernelSize / 2;
-//     float sum = 0.0f; // For normalization
-
-//     for (int i = -halfSize; i <= halfSize; ++i) {
-//         float exponent = std::exp(-0.5f * i * i / (sigma * sigma));
-//         kernel[i + halfSize] = exponent / (std::sqrt(2 * M_PI) * sigma);
-//         sum += kernel[i + halfSize];
-//     }
-
-//     // Normalize the kernel to ensure the sum is 1.
-//     for (auto &value : kernel) {
-//         value /= sum;
-//     }
-
-//     return kernel;
-// }
-
-// void ThreeDFilter::applyGaussianBlur1D(std::vector<unsigned char>& line, const std::vector<float>& kernel, int halfSize) {
-//     std::vector<unsigned char> tempLine(line.size());
-
-//     // Apply the 1D blur for a line in one dimension
-//     for (size_t i = 0; i < line.size(); ++i) {
-//         float sum = 0.0;
-//         // Apply the kernel to each pixel in the line
-//         for (int k = -halfSize; k <= halfSize; ++k) {
-//             int index = std::clamp(static_cast<int>(i) + k, 0, static_cast<int>(line.size()) - 1);
-//             sum += line[index] * kernel[halfSize + k];
-//         }
-//         tempLine[i] = static_cast<unsigned char>(std::clamp(static_cast<int>(sum), 0, 255));
-//     }
-
-//     line = std::move(tempLine);
-// }
-
-// void ThreeDFilter::gaussianBlur(Volume& volume, int kernelSize, float sigma) {
-//     // Assuming sigma is constant, precompute the kernel
-//     auto kernel = precomputeGaussianKernel(sigma, kernelSize);
-//     int halfSize = kernelSize / 2;
-
-//     // Get a copy of the data from the volume since getData() returns a const reference
-//     auto data = volume.getData();
-//     int width = volume.getWidth();
-//     int height = volume.getHeight();
-//     int depth = volume.getDepth();
-//     int channels = volume.getChannels();
-
-//     // Temporary storage for the intermediate results after blurring in each direction
-//     std::vector<std::vector<unsigned char>> tempDataX(depth, std::vector<unsigned char>(width * height * channels));
-//     std::vector<std::vector<unsigned char>> tempDataY(depth, std::vector<unsigned char>(width * height * channels));
-//     std::vector<std::vector<unsigned char>> tempDataZ(depth, std::vector<unsigned char>(width * height * channels));
-
-//     // Apply the Gaussian blur in the x-direction
-//     for (int z = 0; z < depth; ++z) {
-//         for (int y = 0; y < height; ++y) {
-//             for (int ch = 0; ch < channels; ++ch) {
-//                 std::vector<unsigned char> line(width);
-//                 for (int x = 0; x < width; ++x) {
-//                     line[x] = data[z][(y * width + x) * channels + ch];
-//                 }
-//                 applyGaussianBlur1D(line, kernel, halfSize);
-//                 for (int x = 0; x < width; ++x) {
-//                     tempDataX[z][(y * width + x) * channels + ch] = line[x];
-//                 }
-//             }
-//         }
-//     }
-
-//     // Apply the Gaussian blur in the y-direction
-//     for (int z = 0; z < depth; ++z) {
-//         for (int x = 0; x < width; ++x) {
-//             for (int ch = 0; ch < channels; ++ch) {
-//                 std::vector<unsigned char> line(height);
-//                 for (int y = 0; y < height; ++y) {
-//                     line[y] = tempDataX[z][(y * width + x) * channels + ch];
-//                 }
-//                 applyGaussianBlur1D(line, kernel, halfSize);
-//                 for (int y = 0; y < height; ++y) {
-//                     tempDataY[z][(y * width + x) * channels + ch] = line[y];
-//                 }
-//             }
-//         }
-//     }
-
-//     // Apply the Gaussian blur in the z-direction
-//     for (int y = 0; y < height; ++y) {
-//         for (int x = 0; x < width; ++x) {
-//             for (int ch = 0; ch < channels; ++ch) {
-//                 std::vector<unsigned char> line(depth);
-//                 for (int z = 0; z < depth; ++z) {
-//                     line[z] = tempDataY[z][(y * width + x) * channels + ch];
-//                 }
-//                 applyGaussianBlur1D(line, kernel, halfSize);
-//                 for (int z = 0; z < depth; ++z) {
-//                     tempDataZ[z][(y * width + x) * channels + ch] = line[z];
-//                 }
-//             }
-//         }
-//     }
-
-//     // Once all the blurring is done, use setData to update the volume's data
-//     volume.setData(tempDataZ);
-// }
+/**
+ * @brief Applies the separable Gaussian blur to the output slices [zBegin, zEnd).
+ *
+ * The xy-blurred planes of the kernelSize slices around the current output slice are kept
+ * in a ring buffer, so each source slice is blurred in x and y only once per slab and the
+ * z pass is a weighted sum of whole planes.
+ * @param volume The source volume.
+ * @param kernel The normalised 1D kernel.
+ * @param output The destination buffer, laid out like the volume data.
+ * @param zBegin The first output slice of the slab.
+ * @param zEnd One past the last output slice of the slab.
+ */
+void ThreeDFilter::gaussianBlurSlab(const Volume& volume, const std::vector<float>& kernel,
+                                   unsigned char* output, int zBegin, int zEnd) {
+    int depth = volume.getDepth();
+    int kernelSize = static_cast<int>(kernel.size());
+    int halfSize = kernelSize / 2;
+    size_t sliceSize = volume.getZStride();
+
+    std::vector<float> rowsX(sliceSize);
+    std::vector<float> line(static_cast<size_t>(volume.getWidth() + 2 * halfSize) * volume.getChannels());
+    std::vector<float> planes(sliceSize * kernelSize);
+    std::vector<int> planeSlice(kernelSize, -1);
+    std::vector<float> sum(sliceSize);
+
+    // The clamped window always spans at most kernelSize distinct slices, so slot zz % kernelSize is free
+    auto getPlane = [&](int zz) -> const float* {
+        int slot = zz % kernelSize;
+        float* plane = planes.data() + slot * sliceSize;
+        if (planeSlice[slot] != zz) {
+            blurSliceXY(volume, zz, kernel, rowsX.data(), line.data(), plane);
+            planeSlice[slot] = zz;
+        }
+        return plane;
+    };
 
+    for (int z = zBegin; z < zEnd; z++) {
+        const float* first = getPlane(clamp(z - halfSize, 0, depth - 1));
+        for (size_t i = 0; i < sliceSize; i++) {
+            sum[i] = first[i] * kernel[0];
+        }
+        for (int k = 1; k < kernelSize; k++) {
+            const float* plane = getPlane(clamp(z + k - halfSize, 0, depth - 1));
+            float weight = kernel[k];
+            for (size_t i = 0; i < sliceSize; i++) {
+                sum[i] += plane[i] * weight;
+            }
+        }
 
+        unsigned char* out = output + z * sliceSize;
+        for (size_t i = 0; i < sliceSize; i++) {
+            out[i] = static_cast<unsigned char>(clamp(static_cast<int>(sum[i]), 0, 255));
+        }
+    }
+}
 
-// void ThreeDFilter::medianBlur(Volume& volume, int kernelSize) {
-//     int width = volume.getWidth();
-//     int height = volume.getHeight();
-//     int depth = volume.getDepth();
-//     int channels = volume.getChannels();
-//     int halfSize = kernelSize / 2;
+/**
+ * @brief Runs a slab function over the whole depth of a volume on the worker pool.
+ *
+ * The output slices are split into slabCount contiguous z-slabs of near-equal size. Each slab
+ * writes only its own output slices, so the result does not depend on the thread count.
+ * @param depth The number of slices in the volume.
+ * @param slabCount The number of slabs to split the depth into.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ * @param slabFunction Called as slabFunction(zBegin, zEnd) for every slab.
+ */
+template <typename SlabFunction>
+static void forEachSlab(int depth, int slabCount, int threadCount, SlabFunction&& slabFunction) {
+    slabCount = clamp(slabCount, 1, depth);
+    Parallel::parallelFor(0, slabCount, [&](int slab) {
+        int zBegin = static_cast<int>(static_cast<long long>(depth) * slab / slabCount);
+        int zEnd = static_cast<int>(static_cast<long long>(depth) * (slab + 1) / slabCount);
+        slabFunction(zBegin, zEnd);
+    }, threadCount);
+}
 
-//     std::vector<std::vector<unsigned char>> newVolumeData(depth, std::vector<unsigned char>(width * height * channels));
+/**
+ * @brief Applies a Gaussian blur to a given volume.
+ *
+ * The kernel is separable, so the blur runs as three 1D passes (x, y, z) costing 3k
+ * multiply-adds per voxel instead of k^3. Borders are clamped to the nearest edge voxel,
+ * as with the full 3D kernel. The volume is split into one z-slab per thread; each slab
+ * re-blurs the k - 1 planes it shares with its neighbours, and the output is identical
+ * for any thread count.
+ * @param volume A reference to the Volume object to blur.
+ * @param kernelSize The size of the Gaussian kernel (must be an odd number).
+ * @param sigma The standard deviation of the Gaussian distribution used for the kernel.
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
+ */
+void ThreeDFilter::gaussianBlur(Volume& volume, int kernelSize, float sigma, int threadCount) {
+    if (volume.getVoxelCount() == 0) {
+        return;
+    }
 
-//     for (int z = 0; z < depth; z++) {
-//         for (int y = 0; y < height; y++) {
-//             for (int x = 0; x < width; x++) {
-//                 for (int ch = 0; ch < channels; ch++) {
-//                     std::array<int, 256> histogram = {0};
-//                     for (int kz = -halfSize; kz <= halfSize; kz++) {
-//                         for (int ky = -halfSize; ky <= halfSize; ky++) {
-//                             for (int kx = -halfSize; kx <= halfSize; kx++) {
-//                                 int nx = std::max(0, std::min(x + kx, width - 1));
-//                                 int ny = std::max(0, std::min(y + ky, height - 1));
-//                                 int nz = std::max(0, std::min(z + kz, depth - 1));
-//                                 unsigned char value = volume.getData()[nz][((ny * width + nx) * channels) + ch];
-//                                 histogram[value]++;
-//                             }
-//                         }
-//                     }
+    std::vector<float> kernel = gaussianKernel1D(kernelSize, sigma);
+    VoxelBuffer newVolumeData(volume.getVoxelCount());
+    int threads = Parallel::resolveThreadCount(threadCount);
+    forEachSlab(volume.getDepth(), threads, threads, [&](int zBegin, int zEnd) {
+        gaussianBlurSlab(volume, kernel, newVolumeData.data(), zBegin, zEnd);
+    });
 
-//                     int count = 0;
-//                     unsigned char medianValue = 0;
-//                     for (int i = 0; i < 256; i++) {
-//                         count += histogram[i];
-//                         if (count >= (kernelSize * kernelSize * kernelSize) / 2) {
-//                             medianValue = i;
-//                             break;
-//                         }
-//                     }
+    volume.setData(std::move(newVolumeData));
+}
 
-//                     newVolumeData[z][((y * width + x) * channels) + ch] = medianValue;
-//                 }
-//             }
-//         }
-//     }
 
-//     volume.setData(newVolumeData);
-// }
 
 /**
- * @brief Applies a median blur to a given volume.
- * @param volume A reference to the Volume object to apply the median blur.
+ * @brief Applies the exact median filter to the output slices [zBegin, zEnd).
+ *
+ * For every output row, each x position keeps a column histogram of the k x k voxels
+ * (y - h..y + h, z - h..z + h) at that x. The window histogram slides along x by adding the
+ * column that enters and subtracting the one that leaves, in the style of Perreault-Hebert.
+ * Moving to the next row only swaps k voxels in and out of every column, so the work per
+ * voxel grows with k rather than with the k^3 samples of the window.
+ * Coordinates outside the volume are clamped to the nearest edge voxel.
+ * @param volume The source volume.
  * @param kernelSize The size of the cubic kernel (must be an odd number).
+ * @param output The destination buffer, laid out like the volume data.
+ * @param zBegin The first output slice of the slab.
+ * @param zEnd One past the last output slice of the slab.
  */
-void ThreeDFilter::medianBlur(Volume& volume, int kernelSize) {
+void ThreeDFilter::medianBlurSlab(const Volume& volume, int kernelSize, unsigned char* output, int zBegin, int zEnd) {
     int width = volume.getWidth();
     int height = volume.getHeight();
     int depth = volume.getDepth();
     int channels = volume.getChannels();
     int halfSize = kernelSize / 2;
+    uint32_t medianRank = static_cast<uint32_t>(kernelSize) * kernelSize * kernelSize / 2;
+    const unsigned char* src = volume.getData();
 
-    std::vector<std::vector<unsigned char>> newVolumeData(depth, std::vector<unsigned char>(width * height * channels));
+    std::vector<RankHistogram<uint16_t>> columns(width);
+    RankHistogram<uint32_t> window;
 
-    for (int z = 0; z < depth; z++) {
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                for (int ch = 0; ch < channels; ch++) {
-                    unsigned char minVal = 255;
-                    unsigned char maxVal = 0;
+    for (int z = zBegin; z < zEnd; z++) {
+        for (int ch = 0; ch < channels; ch++) {
+            // Fill the column histograms for the first row of this slice
+            for (auto& column : columns) {
+                column.clear();
+            }
+            for (int kz = -halfSize; kz <= halfSize; kz++) {
+                int nz = clamp(z + kz, 0, depth - 1);
+                for (int ky = -halfSize; ky <= halfSize; ky++) {
+                    const unsigned char* row = src + volume.index(0, clamp(ky, 0, height - 1), nz, ch);
+                    for (int x = 0; x < width; x++) {
+                        columns[x].add(row[x * channels]);
+                    }
+                }
+            }
+
+            for (int y = 0; y < height; y++) {
+                if (y > 0) {
+                    // Slide every column down one row: drop row y - h - 1, take in row y + h
+                    int leaving = clamp(y - halfSize - 1, 0, height - 1);
+                    int entering = clamp(y + halfSize, 0, height - 1);
                     for (int kz = -halfSize; kz <= halfSize; kz++) {
-                        for (int ky = -halfSize; ky <= halfSize; ky++) {
-                            for (int kx = -halfSize; kx <= halfSize; kx++) {
-                                int nx = clamp(x + kx, 0, width - 1);
-                                int ny = clamp(y + ky, 0, height - 1);
-                                int nz = clamp(z + kz, 0, depth - 1);
-                                unsigned char value = volume.getData()[nz][((ny * width + nx) * channels) + ch];
-                                maxVal = std::max(maxVal, value);
-                                minVal = std::min(minVal, value);
-                            }
+                        int nz = clamp(z + kz, 0, depth - 1);
+                        const unsigned char* oldRow = src + volume.index(0, leaving, nz, ch);
+                        const unsigned char* newRow = src + volume.index(0, entering, nz, ch);
+                        for (int x = 0; x < width; x++) {
+                            columns[x].remove(oldRow[x * channels]);
+                            columns[x].add(newRow[x * channels]);
                         }
                     }
+                }
 
-                    // Approximating median based on uniform distribution assumption
-                    unsigned char approxMedian = (minVal + maxVal) / 2;
-                    newVolumeData[z][((y * width + x) * channels) + ch] = approxMedian;
+                window.clear();
+                for (int kx = -halfSize; kx <= halfSize; kx++) {
+                    window.addHistogram(columns[clamp(kx, 0, width - 1)]);
+                }
+
+                unsigned char* out = output + volume.index(0, y, z, ch);
+                for (int x = 0; x < width; x++) {
+                    if (x > 0) {
+                        window.addHistogram(columns[clamp(x + halfSize, 0, width - 1)]);
+                        window.subtractHistogram(columns[clamp(x - halfSize - 1, 0, width - 1)]);
+                    }
+                    out[x * channels] = window.select(medianRank);
                 }
             }
         }
     }
-
-    volume.setData(newVolumeData);
 }
 
 /**
- * @brief Calculates the median value from a vector of unsigned characters.
- * @param values A reference to the vector of unsigned char values.
- * @return The median value as an unsigned char.
+ * @brief Applies the 3x3x3 median filter to the output slices [zBegin, zEnd) with a median network.
+ *
+ * Voxels whose 27 neighbours all lie inside the volume are filtered a row at a time with the
+ * vectorised MedianNetwork<27>, which handles the interleaved channels directly. Voxels on the
+ * faces of the volume clamp their neighbours to the nearest edge voxel, like medianBlurSlab,
+ * and run the same network on scalars.
+ * @param volume The source volume.
+ * @param output The destination buffer, laid out like the volume data.
+ * @param zBegin The first output slice of the slab.
+ * @param zEnd One past the last output slice of the slab.
  */
-unsigned char ThreeDFilter::median(std::vector<unsigned char>& values) {
-    selectionSort(values);
-    if (values.size() % 2 == 0) {
-        return (values[values.size() / 2 - 1] + values[values.size() / 2]) / 2;
-    } else {
-        return values[values.size() / 2];
+void ThreeDFilter::medianNetworkSlab(const Volume& volume, unsigned char* output, int zBegin, int zEnd) {
+    int width = volume.getWidth();
+    int height = volume.getHeight();
+    int depth = volume.getDepth();
+    int channels = volume.getChannels();
+    const unsigned char* src = volume.getData();
+
+    std::ptrdiff_t offsets[27];
+    int t = 0;
+    for (int kz = -1; kz <= 1; kz++) {
+        for (int ky = -1; ky <= 1; ky++) {
+            for (int kx = -1; kx <= 1; kx++) {
+                offsets[t++] = kz * static_cast<std::ptrdiff_t>(volume.getZStride()) +
+                               ky * static_cast<std::ptrdiff_t>(volume.getYStride()) + kx * channels;
+            }
+        }
+    }
+
+    auto edgeMedian = [&](int x, int y, int z) {
+        for (int ch = 0; ch < channels; ch++) {
+            unsigned char values[27];
+            int i = 0;
+            for (int kz = -1; kz <= 1; kz++) {
+                for (int ky = -1; ky <= 1; ky++) {
+                    for (int kx = -1; kx <= 1; kx++) {
+                        values[i++] = src[volume.index(clamp(x + kx, 0, width - 1), clamp(y + ky, 0, height - 1),
+                                                       clamp(z + kz, 0, depth - 1), ch)];
+                    }
+                }
+            }
+            output[volume.index(x, y, z, ch)] = MedianNetwork<27>::select(values);
+        }
+    };
+
+    for (int z = zBegin; z < zEnd; z++) {
+        for (int y = 0; y < height; y++) {
+            bool inner = z > 0 && z < depth - 1 && y > 0 && y < height - 1 && width > 2;
+            if (!inner) {
+                for (int x = 0; x < width; x++) {
+                    edgeMedian(x, y, z);
+                }
+                continue;
+            }
+            edgeMedian(0, y, z);
+            std::size_t begin = volume.index(1, y, z);
+            MedianNetwork<27>::medianRun(src + begin, offsets, output + begin, static_cast<std::size_t>(width - 2) * channels);
+            edgeMedian(width - 1, y, z);
+        }
     }
 }
 
 /**
- * @brief Sorts a vector of unsigned char values using the selection sort algorithm.
- * @param arr A reference to the vector of unsigned char values to be sorted.
+ * @brief Applies a median blur to a given volume.
+ *
+ * Each voxel is replaced by the exact median of the kernelSize^3 voxels around it, using
+ * sliding histograms (see medianBlurSlab), or a median network for 3x3x3 kernels (see
+ * medianNetworkSlab). Slices are independent, so the volume is split into several small
+ * z-slabs per thread and threads claim them as they finish.
+ * @param volume A reference to the Volume object to apply the median blur.
+ * @param kernelSize The size of the cubic kernel (must be an odd number).
+ * @param threadCount The number of worker threads (0 uses Parallel's default).
  */
-void ThreeDFilter::selectionSort(std::vector<unsigned char>& arr) {
-    for (size_t i = 0; i < arr.size() - 1; i++) {
-        size_t min_idx = i;
-        for (size_t j = i + 1; j < arr.size(); j++) {
-            if (arr[j] < arr[min_idx]) {
-                min_idx = j;
-            }
-        }
-        // Swap the found minimum element with the first element
-        unsigned char temp = arr[min_idx];
-        arr[min_idx] = arr[i];
-        arr[i] = temp;
+void ThreeDFilter::medianBlur(Volume& volume, int kernelSize, int threadCount) {
+    if (volume.getVoxelCount() == 0) {
+        return;
     }
+
+    VoxelBuffer newVolumeData(volume.getVoxelCount());
+    int threads = Parallel::resolveThreadCount(threadCount);
+    forEachSlab(volume.getDepth(), threads * 4, threads, [&](int zBegin, int zEnd) {
+        if (kernelSize == 3) {
+            medianNetworkSlab(volume, newVolumeData.data(), zBegin, zEnd);
+        } else {
+            medianBlurSlab(volume, kernelSize, newVolumeData.data(), zBegin, zEnd);
+        }
+    });
+
+    volume.setData(std::move(newVolumeData));
 }
@@ -8,6 +8,7 @@
 #define THREEDFILTER_H
 
 #include "Volume.h"
+#include <vector>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -16,19 +17,24 @@
 
 class ThreeDFilter {
 public:
-    static void gaussianBlur(Volume& volume, int kernelSize, float sigma);
+    // threadCount <= 0 uses Parallel::getThreadCount(); results do not depend on it
+    static void gaussianBlur(Volume& volume, int kernelSize, float sigma, int threadCount = 0);
 
-    static void medianBlur(Volume& volume, int kernelSize);
+    static void medianBlur(Volume& volume, int kernelSize, int threadCount = 0);
 
 private:
 
-    static float gaussian(float x, float y, float z, float sigma);
-    static unsigned char median(std::vector<unsigned char>& values);
-    static void selectionSort(std::vector<unsigned char>& arr);
-
-    //helper functions that optimize the gaussian blur
-    //static std::vector<float> precomputeGaussianKernel(int kernelSize, float sigma);
-    // static void applyGaussianBlur1D(std::vector<unsigned char>& line, const std::vector<float>& kernel, int halfSize);
+    // Helpers for the separable gaussian blur
+    static std::vector<float> gaussianKernel1D(int kernelSize, float sigma);
+    static void blurSliceXY(const Volume& volume, int z, const std::vector<float>& kernel,
+                            float* rowsX, float* line, float* plane);
+    static void gaussianBlurSlab(const Volume& volume, const std::vector<float>& kernel,
+                                 unsigned char* output, int zBegin, int zEnd);
+
+    // Sliding-histogram median over a slab of output slices
+    static void medianBlurSlab(const Volume& volume, int kernelSize, unsigned char* output, int zBegin, int zEnd);
+    // 3x3x3 median over a slab of output slices using a median selection network
+    static void medianNetworkSlab(const Volume& volume, unsigned char* output, int zBegin, int zEnd);
 };
 
 #endif // THREEDFILTER_H
\ No newline at end of file
@@ -7,9 +7,9 @@
 #include "ThreeDFilterTest.h"
 #include "Volume.h"
 #include "ThreeDFilter.h"
+#include "Histogram.h"
 #include <iostream>
 #include <cmath>
-#include <numeric>
 
 void ThreeDFilterTest::run(int testType) {
     // Use a switch statement to execute only the selected tests
@@ -26,20 +26,7 @@ void ThreeDFilterTest::run(int testType) {
     }
 }
 double ThreeDFilterTest::calculateStdDev(const Volume& volume) {
-    const auto& data = volume.getData();
-    std::vector<double> intensities;
-    for (const auto& slice : data) {
-        for (unsigned char pixel : slice) {
-            intensities.push_back(static_cast<double>(pixel));
-        }
-    }
-
-    double mean = std::accumulate(intensities.begin(), intensities.end(), 0.0) / intensities.size();
-    double varianceSum = 0.0;
-    for (double value : intensities) {
-        varianceSum += (value - mean) * (value - mean);
-    }
-    return std::sqrt(varianceSum / intensities.size());
+    return Histogram(volume).merged().standardDeviation();
 }
 
 void ThreeDFilterTest::testGaussianBlur() {
@@ -82,4 +69,4 @@ void ThreeDFilterTest::testMedianBlur() {
     } else {
         std::cerr << "Median Blur Test Failed: Standard deviation did not decrease." << std::endl;
     }
-}
\ No newline at end of file
+}
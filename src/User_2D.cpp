@@ -35,8 +35,10 @@
 #include "ImageBlur.h"
 #include "ColourCorrection.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 
@@ -81,6 +83,38 @@ int selectImage(const std::vector<std::string>& images) {
     return imageChoice;
 }
 
+/**
+ * Prompts until the user enters a whole number within the given range.
+ *
+ * @param prompt The text shown before each attempt.
+ * @param minimum The smallest accepted number.
+ * @param maximum The largest accepted number.
+ * @return The number entered, or minimum if the input ends.
+ */
+int readNumber(const std::string& prompt, int minimum, int maximum) {
+    std::string userInput;
+    while (true) {
+        std::cout << prompt;
+        if (!(std::cin >> userInput)) {
+            return minimum;
+        }
+
+        try {
+            int number = std::stoi(userInput);
+            if (number >= minimum && number <= maximum) {
+                return number;
+            }
+            std::cerr << "Invalid input, please enter a number from " << minimum << " to " << maximum << "." << std::endl;
+        }
+        catch (std::invalid_argument const& e) {
+            std::cerr << "Invalid input, please enter a number." << std::endl;
+        }
+        catch (std::out_of_range const& e) {
+            std::cerr << "Invalid input, number out of range." << std::endl;
+        }
+    }
+}
+
 
 /**
  * Applies edge detection to a given image and saves the result.
@@ -105,13 +139,13 @@ std::string applyEdgeDetection(const fs::path& projectDir, const fs::path& image
     int choice;
     bool validChoice = false;
     while (!validChoice) {
-        std::cout << "\nChoose edge detection method:\n1. Sobel\n2. Prewitt\n3. Scharr\n4. Roberts Cross\nEnter choice (1-4): ";
+        std::cout << "\nChoose edge detection method:\n1. Sobel\n2. Prewitt\n3. Scharr\n4. Roberts Cross\n5. Canny\nEnter choice (1-5): ";
         std::string userInput;
         std::cin >> userInput;
 
         try {
             choice = std::stoi(userInput);
-            if (choice >= 1 && choice <= 4) {
+            if (choice >= 1 && choice <= 5) {
                 validChoice = true;
             }
             else {
@@ -126,6 +160,33 @@ std::string applyEdgeDetection(const fs::path& projectDir, const fs::path& image
         }
     }
 
+    // Canny needs its hysteresis thresholds
+    int lowThreshold = 40;
+    int highThreshold = 100;
+    if (choice == 5) {
+        bool validThresholds = false;
+        while (!validThresholds) {
+            std::cout << "Enter low and high thresholds (e.g., 40 100): ";
+            std::string lowInput, highInput;
+            std::cin >> lowInput >> highInput;
+
+            try {
+                lowThreshold = std::stoi(lowInput);
+                highThreshold = std::stoi(highInput);
+                validThresholds = true;
+            }
+            catch (std::invalid_argument const& e) {
+                std::cerr << "Invalid input, please enter two numbers." << std::endl;
+            }
+            catch (std::out_of_range const& e) {
+                std::cerr << "Invalid input, number out of range." << std::endl;
+            }
+        }
+        // Thresholds beyond the largest Sobel magnitude would select nothing anyway
+        lowThreshold = std::min(std::max(lowThreshold, 0), EdgeDetection::maxGradientMagnitude);
+        highThreshold = std::min(std::max(highThreshold, 0), EdgeDetection::maxGradientMagnitude);
+    }
+
     // Switch different types of edge detection
     switch (choice) {
         case 1:
@@ -144,10 +205,14 @@ std::string applyEdgeDetection(const fs::path& projectDir, const fs::path& image
             edgeDetectionTypeDir = edgeDetectionDir / "robertscross";
             edgeDetectionTypeStr = "robertscross";
             break;
+        case 5:
+            edgeDetectionTypeDir = edgeDetectionDir / "canny";
+            edgeDetectionTypeStr = "canny";
+            break;
     }
 
     EdgeOperator edgeOperator = EdgeDetection::getEdgeOperatorFromChoice(choice);
-    EdgeDetection edgeDetector(edgeOperator);
+    EdgeDetection edgeDetector(edgeOperator, lowThreshold, highThreshold);
     edgeDetector.applyEdge(image, choice);
 
     // Ensure the directory exists
@@ -189,13 +254,13 @@ std::string applyBlur(const fs::path& projectDir, const fs::path& imagePath, Ima
     int choice;
     bool validChoice = false;
     while (!validChoice) {
-        std::cout << "\nChoose blur method:\n1. Box Blur\n2. Median Blur\n3. Gaussian Blur\nEnter choice (1-3): ";
+        std::cout << "\nChoose blur method:\n1. Box Blur\n2. Median Blur\n3. Gaussian Blur\n4. Adaptive Median (salt and pepper removal)\nEnter choice (1-4): ";
         std::string userInput;
         std::cin >> userInput;
 
         try {
             choice = std::stoi(userInput);
-            if (choice >= 1 && choice <= 3) {
+            if (choice >= 1 && choice <= 4) {
                 validChoice = true;
             }
             else {
@@ -211,9 +276,15 @@ std::string applyBlur(const fs::path& projectDir, const fs::path& imagePath, Ima
     }
 
     int kernelSize;
-    std::cout << "Enter kernel size (e.g., 3 for 3x3): ";
+    std::cout << (choice == 4 ? "Enter maximum kernel size (e.g., 7 for 7x7): " : "Enter kernel size (e.g., 3 for 3x3): ");
     std::cin >> kernelSize;
 
+    float sigma = 1.0f;
+    if (choice == 3) {
+        std::cout << "Enter sigma value (e.g., 1.0): ";
+        std::cin >> sigma;
+    }
+
     // Construct the path to the results directory and ensure it exists
     fs::path blurDir = projectDir / "6-blur";
     if (!fs::exists(blurDir)) {
@@ -235,6 +306,10 @@ std::string applyBlur(const fs::path& projectDir, const fs::path& imagePath, Ima
             blurTypeDir = blurDir / "gaussian";
             blurTypeStr = "Gaussian";
             break;
+        case 4:
+            blurTypeDir = blurDir / "adaptive_median";
+            blurTypeStr = "AdaptiveMedian";
+            break;
     }
 
     // Ensure the directory exists
@@ -252,7 +327,10 @@ std::string applyBlur(const fs::path& projectDir, const fs::path& imagePath, Ima
             blur = new ImageBlur(Median, kernelSize);
             break;
         case 3:
-            blur = new ImageBlur(Gaussian, kernelSize);
+            blur = new ImageBlur(Gaussian, kernelSize, sigma);
+            break;
+        case 4:
+            blur = new ImageBlur(AdaptiveMedian, kernelSize);
             break;
     }
 
@@ -296,6 +374,28 @@ std::string applyBlur(const fs::path& projectDir, const fs::path& imagePath, Ima
 std::string applyColourCorrection(const fs::path& projectDir, const fs::path& imagePath, Image& image, int filter, int multiple) {
     ColorSpace colorSpace = ColorSpace::HSV; // Default to HSV
     std::string histogramType;
+
+    // Histogram equalisation is either global or contrast-limited adaptive (CLAHE)
+    int histogramMethod = 1;
+    if (filter == 3) {
+        std::cout << "Choose histogram equalisation method:\n"
+                  << "1. Global\n"
+                  << "2. CLAHE (contrast-limited adaptive)\n";
+        histogramMethod = readNumber("Enter choice (1-2): ", 1, 2);
+    }
+
+    // Thresholds are either given, chosen automatically by Otsu's method, or local to each pixel's window
+    int thresholdMethod = 1;
+    if (filter == 4) {
+        std::cout << "Choose thresholding method:\n"
+                  << "1. Fixed threshold\n"
+                  << "2. Otsu (automatic, 2-4 classes)\n"
+                  << "3. Local mean - C\n"
+                  << "4. Local Bradley\n"
+                  << "5. Local Sauvola\n";
+        thresholdMethod = readNumber("Enter choice (1-5): ", 1, 5);
+    }
+
     if ((filter == 3 || filter == 4) && image.getChannels() != 1) {
         std::cout << "Choose color space for processing:\n"
                   << "1. HSL\n"
@@ -312,18 +412,150 @@ std::string applyColourCorrection(const fs::path& projectDir, const fs::path& im
         colorSpace = (colorSpaceChoice == 1) ? ColorSpace::HSL : ColorSpace::HSV;
     }
 
+    // Noise is salt and pepper, Gaussian or speckle, all from a seeded generator
+    int noiseType = 1;
+    if (filter == 5) {
+        std::cout << "Choose noise type:\n"
+                  << "1. Salt and pepper\n"
+                  << "2. Gaussian\n"
+                  << "3. Speckle\n";
+        noiseType = readNumber("Enter choice (1-3): ", 1, 3);
+    }
+
     int parameter = 0; // For methods that require an additional parameter
-    if (filter == 2 || filter == 4 || filter == 5) {
+    if (filter == 2 || (filter == 4 && thresholdMethod == 1) || (filter == 5 && noiseType != 2 && noiseType != 3)) {
         std::cout << "Enter parameter value (brightness level, threshold value, or noise percentage): ";
         std::cin >> parameter;
     }
+    else if (filter == 5) {
+        parameter = readNumber(noiseType == 2 ? "Enter standard deviation in grey levels: "
+                                              : "Enter standard deviation in percent of the value: ",
+                               0, 255);
+    }
 
+    int tileGrid = 8;
     ColourCorrectionType correctionType = static_cast<ColourCorrectionType>(filter - 1);
-    ColourCorrection correction(correctionType, parameter, colorSpace);
+    if (filter == 3 && histogramMethod == 2) {
+        // Defaults for input that ends early
+        parameter = 2;
+        bool validClahe = false;
+        while (!validClahe) {
+            std::cout << "Enter clip limit and tiles per axis (e.g., 2 8): ";
+            std::string clipInput, tilesInput;
+            if (!(std::cin >> clipInput >> tilesInput)) {
+                break;
+            }
+
+            try {
+                int clipLimit = std::stoi(clipInput);
+                int tiles = std::stoi(tilesInput);
+                validClahe = clipLimit > 0 && tiles >= 1;
+                if (validClahe) {
+                    parameter = clipLimit;
+                    tileGrid = tiles;
+                } else {
+                    std::cerr << "Invalid input, the clip limit must be above 0 and there must be at least 1 tile." << std::endl;
+                }
+            }
+            catch (std::invalid_argument const& e) {
+                std::cerr << "Invalid input, please enter two numbers." << std::endl;
+            }
+            catch (std::out_of_range const& e) {
+                std::cerr << "Invalid input, number out of range." << std::endl;
+            }
+        }
+        correctionType = CLAHE;
+    }
+    if (filter == 4 && thresholdMethod == 2) {
+        parameter = readNumber("Enter number of classes (2-4): ", 2, 4);
+        correctionType = OtsuThresholding;
+    }
+    float sensitivity = 0.0f;
+    if (filter == 4 && thresholdMethod >= 3 && thresholdMethod <= 5) {
+        const char* sensitivityName[] = {"C", "percentage below the mean", "k"};
+        const char* example[] = {"15 5", "31 15", "25 0.2"};
+        // Defaults for input that ends early
+        parameter = 15;
+        bool validWindow = false;
+        while (!validWindow) {
+            std::cout << "Enter window size and " << sensitivityName[thresholdMethod - 3]
+                      << " (e.g., " << example[thresholdMethod - 3] << "): ";
+            std::string windowInput, sensitivityInput;
+            if (!(std::cin >> windowInput >> sensitivityInput)) {
+                break;
+            }
+
+            try {
+                int window = std::stoi(windowInput);
+                float value = std::stof(sensitivityInput);
+                validWindow = window >= 3 && window % 2 == 1;
+                if (validWindow) {
+                    parameter = window;
+                    sensitivity = value;
+                } else {
+                    std::cerr << "Invalid input, the window size must be an odd number of at least 3." << std::endl;
+                }
+            }
+            catch (std::invalid_argument const& e) {
+                std::cerr << "Invalid input, please enter two numbers." << std::endl;
+            }
+            catch (std::out_of_range const& e) {
+                std::cerr << "Invalid input, number out of range." << std::endl;
+            }
+        }
+        correctionType = static_cast<ColourCorrectionType>(MeanThresholding + thresholdMethod - 3);
+    }
+    if (filter == 5 && (noiseType == 2 || noiseType == 3)) {
+        correctionType = noiseType == 2 ? GaussianNoise : SpeckleNoise;
+    }
+    ColourCorrection correction = correctionType == MeanThresholding || correctionType == BradleyThresholding ||
+                                          correctionType == SauvolaThresholding
+        ? ColourCorrection(correctionType, parameter, sensitivity, colorSpace)
+        : ColourCorrection(correctionType, parameter, colorSpace, tileGrid);
+    if (filter == 5) {
+        unsigned long long seed = 0;
+        bool validSeed = false;
+        while (!validSeed) {
+            std::cout << "Enter seed (0 for a random one): ";
+            std::string seedInput;
+            if (!(std::cin >> seedInput)) {
+                break;
+            }
+
+            try {
+                // std::stoull would wrap a negative number around instead of rejecting it
+                if (seedInput[0] == '-') {
+                    throw std::invalid_argument("negative seed");
+                }
+                seed = std::stoull(seedInput);
+                validSeed = true;
+            }
+            catch (std::invalid_argument const& e) {
+                std::cerr << "Invalid input, please enter a whole number of at least 0." << std::endl;
+            }
+            catch (std::out_of_range const& e) {
+                std::cerr << "Invalid input, number out of range." << std::endl;
+            }
+        }
+        if (seed != 0) {
+            correction.setSeed(seed);
+        }
+        std::cout << "Noise seed: " << correction.getSeed() << std::endl;
+    }
 
     // Apply the selected colour correction
     correction.apply(image);
 
+    std::string otsuThresholds;
+    if (correctionType == OtsuThresholding) {
+        std::cout << "Otsu thresholds:";
+        for (int threshold : correction.getThresholds()) {
+            std::cout << " " << threshold;
+            otsuThresholds += "_" + std::to_string(threshold);
+        }
+        std::cout << std::endl;
+    }
+
     fs::path ColourCorrectionTypeDir;
     std::string ColourCorrectionTypeStr;
     switch (filter) {
@@ -344,10 +576,24 @@ std::string applyColourCorrection(const fs::path& projectDir, const fs::path& im
         case 3:
             ColourCorrectionTypeDir = projectDir / "3-histogram";
             ColourCorrectionTypeStr = "_" + histogramType;
+            if (correctionType == CLAHE) {
+                ColourCorrectionTypeStr = "_CLAHE" + (histogramType.empty() ? "" : "_" + histogramType) + "_" +
+                                          std::to_string(parameter) + "_" + std::to_string(tileGrid);
+            }
             break;
         case 4:
             ColourCorrectionTypeDir = projectDir / "4-threshold";
-            if (histogramType.empty()) {
+            if (correctionType == OtsuThresholding) {
+                ColourCorrectionTypeStr = "_Otsu" + (histogramType.empty() ? "" : "_" + histogramType) + otsuThresholds;
+            }
+            else if (thresholdMethod >= 3 && thresholdMethod <= 5) {
+                const char* methodName[] = {"_MeanC", "_Bradley", "_Sauvola"};
+                std::ostringstream sensitivityStr;
+                sensitivityStr << sensitivity;
+                ColourCorrectionTypeStr = methodName[thresholdMethod - 3] + (histogramType.empty() ? "" : "_" + histogramType) +
+                                          "_" + std::to_string(parameter) + "_" + sensitivityStr.str();
+            }
+            else if (histogramType.empty()) {
                 ColourCorrectionTypeStr = "_" + std::to_string(parameter);
             }
             else {
@@ -357,6 +603,9 @@ std::string applyColourCorrection(const fs::path& projectDir, const fs::path& im
         case 5:
             ColourCorrectionTypeDir = projectDir / "5-saltandpepper";
             ColourCorrectionTypeStr = "_" + std::to_string(parameter);
+            if (noiseType == 2 || noiseType == 3) {
+                ColourCorrectionTypeStr = (noiseType == 2 ? "_gaussian_" : "_speckle_") + std::to_string(parameter);
+            }
             break;
     }
     // Ensure the directory exists
@@ -467,7 +716,7 @@ void User_2D() {
 
                 // Choose 7 different filters based on user's choice
                 int filter;
-                std::cout << "\nChoose filter:\n1. grayscale\n2. brightness\n3. histogram\n4. threshold\n5. salt and pepper\n6. blur\n7. edge detection\nEnter choice (1-7): ";
+                std::cout << "\nChoose filter:\n1. grayscale\n2. brightness\n3. histogram\n4. threshold\n5. noise\n6. blur\n7. edge detection\nEnter choice (1-7): ";
                 std::cin >> filter;
 
                 switch (filter) {
@@ -528,7 +777,7 @@ void User_2D() {
             // Loop until the user chooses the "Save and Exit" option
             while (true){
                 int filter;
-                std::cout << "\nChoose filter:\n1. grayscale\n2. brightness\n3. histogram\n4. threshold\n5. salt and pepper\n6. blur\n7. edge detection\n8. Save and Exit\nEnter choice (1-8): ";
+                std::cout << "\nChoose filter:\n1. grayscale\n2. brightness\n3. histogram\n4. threshold\n5. noise\n6. blur\n7. edge detection\n8. Save and Exit\nEnter choice (1-8): ";
                 std::cin >> filter;
 
                 if (filter == 8){
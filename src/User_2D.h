@@ -42,6 +42,7 @@
 namespace fs = std::filesystem;
 
 int selectImage(const std::vector<std::string>& images);
+int readNumber(const std::string& prompt, int minimum, int maximum);
 std::string applyEdgeDetection(const fs::path& projectDir, const fs::path& imagePath, Image& image, int multiple);
 std::string applyBlur(const fs::path& projectDir, const fs::path& imagePath, Image& image, int multiple);
 std::string applyColourCorrection(const fs::path& projectDir, const fs::path& imagePath, Image& image, int filter);
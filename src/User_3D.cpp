@@ -26,13 +26,17 @@
  *   - Volume.h
  *   - Projection.h
  *   - ThreeDFilter.h
+ *   - Parallel.h
  *   - Slice.h
+ *   - SlabIndex.h
  *   - <filesystem>, <iostream>, <vector>, <string>
  */
 #include "Volume.h"
 #include "Projection.h"
 #include "ThreeDFilter.h"
+#include "Parallel.h"
 #include "Slice.h"
+#include "SlabIndex.h"
 #include "User_3D.h"
 #include <chrono>
 #include <iostream>
@@ -89,7 +93,8 @@ void User_3D::selectDataset() {
 /**
  * @brief Sets the filter parameters interactively based on user input.
  *
- * Asks the user to choose the filter type and parameters for the Gaussian or Median filter.
+ * Asks the user to choose the filter type and parameters for the Gaussian or Median filter,
+ * and the number of worker threads used for processing.
  *
  * @param filterChoice Reference to store the user's filter choice.
  * @param kernelSize Reference to store the chosen kernel size.
@@ -111,6 +116,11 @@ void User_3D::setFilterParameters(int& filterChoice, int& kernelSize, float& sig
             std::cout << "Enter sigma value (default is 2.0): ";
             std::cin >> sigma; // Assuming validation and error handling for sigma
         }
+
+        int threadCount = 0;
+        std::cout << "Enter number of threads (0 for all " << Parallel::getThreadCount() << " available): ";
+        std::cin >> threadCount;
+        Parallel::setThreadCount(threadCount);
     } else {
         filterType = "NoFilter";
     }
@@ -136,17 +146,21 @@ void User_3D::applyFilter(Volume& processedVolume, int filterChoice, int kernelS
     } else if (filterChoice == 2) {
         ThreeDFilter::medianBlur(processedVolume, kernelSize);
         std::cout << "Median filter applied with kernel size " << kernelSize << ".\n";
+    } else {
+        return;
     }
 
     auto end = high_resolution_clock::now();
-    auto duration = duration_cast<seconds>(end - start).count(); // Convert to seconds
-    std::cout << "Filter application took " << duration << " seconds.\n";
+    auto duration = duration_cast<milliseconds>(end - start).count();
+    std::cout << "Filter application took " << duration << " ms on "
+              << Parallel::getThreadCount() << " thread(s).\n";
 }
 
 /**
  * @brief Generates and saves projection images from the processed volume data.
  *
  * Creates MIP, MinIP, and AIP projections as appropriate for the dataset and saves them to files.
+ * All requested projections are computed together in a single pass over the volume.
  *
  * @param processedVolume The volume from which to generate projections.
  * @param filterType The type of filter applied, affecting the filenames of saved images.
@@ -154,19 +168,21 @@ void User_3D::applyFilter(Volume& processedVolume, int filterChoice, int kernelS
  */
 void User_3D::generateProjections(const Volume& processedVolume, const std::string& filterType, int kernelSize) {
     std::vector<std::string> projectionTypes;
+    int outputs = 0;
     if (datasetName == "confuciusornis") {
         projectionTypes = {"mip", "aip"};
+        outputs = MipOutput | AipOutput;
     } else if (datasetName == "fracture") {
         projectionTypes = {"mip", "minip", "aip"};
+        outputs = MipOutput | MinipOutput | AipOutput;
     }
 
+    std::string kernelSizeStr = (filterType != "NoFilter") ? "_" + filterType + "_" + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) : "_nofilter";
+    ProjectionSet projections = Projection::computeProjections(processedVolume, outputs);
+    Projection::saveProjections(projections, outputDir + "/", kernelSizeStr);
+
     for (const auto& type : projectionTypes) {
-        std::string kernelSizeStr = (filterType != "NoFilter") ? "_" + filterType + "_" + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) + "x" + std::to_string(kernelSize) : "_nofilter";
         std::string outputPath = outputDir + "/" + type + kernelSizeStr + ".png";
-        if (type == "mip") Projection::mip(processedVolume, outputPath);
-        else if (type == "minip" && datasetName == "fracture") Projection::minip(processedVolume, outputPath);
-        else if (type == "aip") Projection::aip(processedVolume, outputPath);
-
         std::cout << type << " projection generated and saved: " << outputPath << "\n";
     }
 }
@@ -175,6 +191,7 @@ void User_3D::generateProjections(const Volume& processedVolume, const std::stri
  * @brief Handles the generation of slice images based on default or user-provided indices.
  *
  * Interactively asks the user if default indices should be used or prompts for custom indices to generate slice images.
+ * The user can also re-save the whole volume as a stack of XZ or YZ slices.
  *
  * @param processedVolume The volume from which to generate slice images.
  */
@@ -203,6 +220,20 @@ void User_3D::handleSliceGeneration(const Volume& processedVolume) {
         generateSlice(processedVolume, xzIndex, "xz");
         generateSlice(processedVolume, yzIndex, "yz");
     }
+
+    char resave = 'n';
+    std::cout << "\nWould you like to re-save the whole volume along another axis? (y/n): ";
+    std::cin >> resave;
+    if (resave == 'y' || resave == 'Y') {
+        int resaveChoice = 0;
+        std::cout << "Enter 1 for XZ slices or 2 for YZ slices: ";
+        std::cin >> resaveChoice;
+        std::string axisDir = outputDir + (resaveChoice == 1 ? "/xz_slices" : "/yz_slices");
+        Volume permuted = Slice::permute(processedVolume, resaveChoice == 1 ? XZY : YZX);
+        if (permuted.saveVolume(axisDir)) {
+            std::cout << permuted.getDepth() << " slices saved to " << axisDir << "\n";
+        }
+    }
 }
 
 /**
@@ -232,10 +263,12 @@ void User_3D::generateSlice(const Volume& processedVolume, int index, const std:
  * @brief Handles the generation of slab images based on default or user-provided indices.
  *
  * Interactively asks the user if default slab ranges should be used or prompts for custom ranges to generate slab projections.
+ * Custom slabs can be requested repeatedly; once a second slab is asked for, a SlabIndex is built so that
+ * every further slab is answered without re-reading the volume.
  *
  * @param processedVolume The volume from which to generate slab projections.
  */
-void User_3D::handleSlabGeneration(const Volume& processedVolume) {
+void User_3D::handleSlabGeneration(Volume& processedVolume) {
     std::cout << "\nWould you like to use default slab indices? (y/n): ";
     char useDefaultSlabs;
     std::cin >> useDefaultSlabs;
@@ -244,15 +277,78 @@ void User_3D::handleSlabGeneration(const Volume& processedVolume) {
         generateDefaultSlabs(processedVolume);
     } else {
         // Ask user for custom slab parameters
-        int startIndex, endIndex;
-        std::cout << "Enter custom slab start index: ";
-        std::cin >> startIndex;
-        std::cout << "Enter custom slab end index: ";
-        std::cin >> endIndex;
-        generateCustomSlab(processedVolume, startIndex, endIndex);
+        char another = 'y';
+        while (another == 'y' || another == 'Y') {
+            int startIndex, endIndex;
+            std::cout << "Enter custom slab start index: ";
+            std::cin >> startIndex;
+            std::cout << "Enter custom slab end index: ";
+            std::cin >> endIndex;
+            generateCustomSlab(processedVolume, startIndex, endIndex);
+
+            another = 'n';
+            std::cout << "Generate another slab? (y/n): ";
+            std::cin >> another;
+            if ((another == 'y' || another == 'Y') && processedVolume.getSlabIndex() == nullptr) {
+                buildSlabIndex(processedVolume);
+            }
+        }
     }
 }
 
+/**
+ * @brief Optionally generates a sliding series of equally thick slab projections.
+ *
+ * Asks for the slab thickness and the step between slabs, then writes the MIP and AIP (plus MinIP
+ * for fracture) of every slab as soon as it is computed, in a single sweep through the volume.
+ *
+ * @param processedVolume The volume from which to generate the slab series.
+ */
+void User_3D::handleSlabSeries(const Volume& processedVolume) {
+    char generateSeries = 'n';
+    std::cout << "\nWould you like to generate a sliding slab series? (y/n): ";
+    std::cin >> generateSeries;
+    if (generateSeries != 'y' && generateSeries != 'Y') {
+        return;
+    }
+
+    int thickness = 0, step = 1;
+    std::cout << "Enter slab thickness (number of slices): ";
+    std::cin >> thickness;
+    std::cout << "Enter step between slabs: ";
+    std::cin >> step;
+    if (thickness < 1 || thickness > processedVolume.getDepth() || step < 1) {
+        std::cout << "Invalid slab series parameters.\n";
+        return;
+    }
+
+    int outputs = MipOutput | AipOutput;
+    if (datasetName == "fracture") {
+        outputs |= MinipOutput;
+    }
+    int slabCount = 0;
+    std::string suffix = "-series_thickslab_";
+    Projection::projectSlabSeries(processedVolume, outputs, thickness, step, [&](const ProjectionSet& slab) {
+        // File names use the same 1-based slice numbers as the custom slabs
+        Projection::saveProjections(slab, outputDir + "/", suffix + std::to_string(slab.minZ + 1) + "_" + std::to_string(slab.maxZ + 1));
+        ++slabCount;
+    });
+    std::cout << slabCount << " slab series projections generated and saved in " << outputDir << "\n";
+}
+
+/**
+ * @brief Builds a SlabIndex for the volume so that later slab projections are answered from it.
+ *
+ * @param processedVolume The volume to index.
+ */
+void User_3D::buildSlabIndex(Volume& processedVolume) {
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+    processedVolume.setSlabIndex(std::make_shared<SlabIndex>(processedVolume));
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    std::cout << "Slab index built in " << duration << " ms.\n";
+}
+
 /**
  * @brief Generates slab projections using default indices specific to the dataset.
  *
@@ -305,5 +401,6 @@ void User_3D::run() {
     generateProjections(processedVolume, filterType, kernelSize);
     handleSliceGeneration(processedVolume);
     handleSlabGeneration(processedVolume);
+    handleSlabSeries(processedVolume);
 
 }
\ No newline at end of file
@@ -27,7 +27,9 @@ private:
     void applyFilter(Volume& processedVolume, int filterChoice, int kernelSize, float sigma); // Apply chosen filter
     void generateProjections(const Volume& processedVolume, const std::string& filterType, int kernelSize); // Generate projections
     void handleSliceGeneration(const Volume& processedVolume); // Generate slices with user choice for default or custom values
-    void handleSlabGeneration(const Volume& processedVolume); // Generate slabs with user choice for default or custom values
+    void handleSlabGeneration(Volume& processedVolume); // Generate slabs with user choice for default or custom values
+    void handleSlabSeries(const Volume& processedVolume); // Generate a sliding series of equally thick slabs
+    void buildSlabIndex(Volume& processedVolume); // Precompute slab summaries for repeated slab queries
 
     // New methods for enhanced functionality
     void generateSlice(const Volume& processedVolume, int index, const std::string& plane); // Generate a single slice
@@ -6,6 +6,7 @@
 #include "ProjectionTest.h"
 
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <string>
 
@@ -16,6 +17,12 @@ void runColourCorrectionTests() {
             "Histogram Equalization",
             "Thresholding",
             "Salt and Pepper Noise",
+            "Point Operations",
+            "CLAHE",
+            "Otsu Thresholding",
+            "Local Thresholding",
+            "Seeded Noise",
+            "Volume Histogram",
             "Back to Main Menu"
     };
 
@@ -53,6 +60,10 @@ void runImageBlurTests() {
             "Median Blur",
             "Box Blur",
             "Gaussian Blur",
+            "Adaptive Median",
+            "Summed-Area Table",
+            "Rank Filter",
+            "Median Network",
             "Back to Main Menu"
     };
 
@@ -91,6 +102,8 @@ void runEdgeDetectionTests() {
             "Prewitt Operator",
             "Scharr Operator",
             "Roberts Cross Operator",
+            "Canny Operator",
+            "Gradient Outputs",
             "Back to Main Menu"
     };
 
@@ -164,6 +177,9 @@ void runProjectionTests() {
             "MIP (Maximum Intensity Projection)",
             "MINIP (Minimum Intensity Projection)",
             "AIP (Average Intensity Projection)",
+            "Slab Index",
+            "Slab Series",
+            "XZ and YZ Slices",
             "Back to Main Menu"
     };
 
@@ -10,11 +10,13 @@
  *
  * Dependencies:
  *   - Volume.h for the declaration of the Volume class.
+ *   - Parallel.h for decoding and encoding slices on worker threads.
  *   - stb_image.h for loading PNG images as volume slices.
  *   - stb_image_write.h for saving volume slices as PNG images.
  *   - Standard libraries: <iostream>, <vector>, <algorithm>, <filesystem>, and <cstring>.
  */
 #include "Volume.h"
+#include "Parallel.h"
 #include "stb_image.h"
 #include "stb_image_write.h"
 #include <iostream>
@@ -31,6 +33,19 @@ namespace fs = std::filesystem;
  */
 Volume::Volume() : width(0), height(0), depth(0), channels(0) {}
 
+/**
+ * @brief Constructs a Volume of the given dimensions backed by one contiguous buffer.
+ *
+ * The voxel contents are left uninitialised; callers are expected to fill every slice.
+ * @param width The width of each slice in voxels.
+ * @param height The height of each slice in voxels.
+ * @param depth The number of slices.
+ * @param channels The number of channels per voxel.
+ */
+Volume::Volume(int width, int height, int depth, int channels)
+    : width(width), height(height), depth(depth), channels(channels),
+      data(static_cast<std::size_t>(width) * height * depth * channels) {}
+
 /**
  * @brief Destructor for the Volume class.
  *
@@ -41,22 +56,53 @@ Volume::~Volume() {
 }
 
 /**
- * @brief Gets the const reference to the volume data.
+ * @brief Gets a read-only pointer to the volume data.
  *
- * Returns a constant reference to the internal data representing the volume.
- * @return A const reference to the data vector of the volume.
+ * Slices are stored back to back, so voxel (x, y, z, ch) is found at index(x, y, z, ch).
+ * @return A pointer to the first byte of the contiguous voxel buffer.
  */
-const std::vector<std::vector<unsigned char>>& Volume::getData() const {
-    return data;
+const unsigned char* Volume::getData() const {
+    return data.data();
+}
+
+/**
+ * @brief Gets a writable pointer to the volume data.
+ *
+ * @return A pointer to the first byte of the contiguous voxel buffer.
+ */
+unsigned char* Volume::getData() {
+    return data.data();
+}
+
+/**
+ * @brief Gets a read-only view of a single slice.
+ *
+ * @param z The 0-based index of the slice.
+ * @return A view over the width x height x channels bytes of slice z.
+ */
+SliceView<const unsigned char> Volume::getSlice(int z) const {
+    return {data.data() + z * getZStride(), width, height, channels};
+}
+
+/**
+ * @brief Gets a writable view of a single slice.
+ *
+ * @param z The 0-based index of the slice.
+ * @return A view over the width x height x channels bytes of slice z.
+ */
+SliceView<unsigned char> Volume::getSlice(int z) {
+    return {data.data() + z * getZStride(), width, height, channels};
 }
 
 /**
  * @brief Frees the memory allocated for the volume and resets its properties.
  *
- * Clears the volume data and sets the width, height, depth, and channels to 0.
+ * Clears the volume data and any slab index, and sets the width, height, depth, and channels to 0.
  */
 void Volume::freeVolume() {
     data.clear();
+    data.shrink_to_fit();
+    slabIndex.reset();
     width = 0;
     height = 0;
     depth = 0;
@@ -67,7 +113,10 @@ void Volume::freeVolume() {
  * @brief Loads volume data from a series of image slices in a directory.
  *
  * Iterates over PNG images in the given directory, loads them as slices of the volume,
- * and checks for consistent dimensions and channel count across slices.
+ * and checks for consistent dimensions and channel count across slices. The first slice
+ * fixes the slice dimensions so the whole stack can be allocated once; the remaining
+ * slices are then decoded on the worker pool and each copied into its own slot. stb_image
+ * always decodes into a buffer it allocates, so that one copy per slice remains.
  * @param directoryPath The filesystem path to the directory containing image slices.
  * @return True if the volume is loaded successfully, false otherwise.
  */
@@ -80,26 +129,48 @@ bool Volume::loadVolume(const std::string& directoryPath) {
         }
     }
     std::sort(fileNames.begin(), fileNames.end());
-    for (const auto& fileName : fileNames) {
-        int w, h, ch;
-        unsigned char* sliceData = stbi_load(fileName.c_str(), &w, &h, &ch, 0);
+    if (fileNames.empty()) {
+        return true;
+    }
+
+    int w, h, ch;
+    unsigned char* firstSlice = stbi_load(fileNames[0].c_str(), &w, &h, &ch, 0);
+    if (!firstSlice) {
+        std::cerr << "Error loading slice: " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+    width = w;
+    height = h;
+    channels = ch;
+    depth = static_cast<int>(fileNames.size());
+    data.resize(getVoxelCount());
+    std::memcpy(data.data(), firstSlice, getZStride());
+    stbi_image_free(firstSlice);
+
+    // Per-slice failure reason; stb keeps its own failure reason per thread
+    std::vector<const char*> errors(depth, nullptr);
+    Parallel::parallelFor(1, depth, [&](int z) {
+        int sw, sh, sch;
+        unsigned char* sliceData = stbi_load(fileNames[z].c_str(), &sw, &sh, &sch, 0);
         if (!sliceData) {
-            std::cerr << "Error loading slice: " << stbi_failure_reason() << std::endl;
-            return false;
+            errors[z] = stbi_failure_reason();
+            return;
         }
-        if (width == 0 && height == 0) {
-            width = w;
-            height = h;
-            channels = ch;
-        } else if (w != width || h != height || ch != channels) {
-            std::cerr << "Error: Slice dimensions or channel count do not match." << std::endl;
-            stbi_image_free(sliceData);
-            return false;
+        if (sw != width || sh != height || sch != channels) {
+            errors[z] = "Slice dimensions or channel count do not match.";
+        } else {
+            std::memcpy(data.data() + z * getZStride(), sliceData, getZStride());
         }
-        data.emplace_back(sliceData, sliceData + (w * h * ch));
         stbi_image_free(sliceData);
+    });
+
+    for (int z = 1; z < depth; ++z) {
+        if (errors[z]) {
+            std::cerr << "Error loading slice " << fileNames[z] << ": " << errors[z] << std::endl;
+            freeVolume();
+            return false;
+        }
     }
-    depth = data.size();
     return true;
 }
 
@@ -122,34 +193,47 @@ int Volume::getHeight() const {
     return height;
 }
 
+/**
+ * @brief Gets the depth of the volume.
+ *
+ * @return The depth of the volume in slices.
+ */
 int Volume::getDepth() const {
     return depth;
 }
 
 /**
- * @brief Gets the depth of the volume.
+ * @brief Gets the number of channels of the volume.
  *
- * @return The depth of the volume in slices.
+ * @return The number of channels in the volume data.
  */
 int Volume::getChannels() const {
     return channels;
 }
 
 /**
- * @brief Gets the number of channels of the volume.
+ * @brief Replaces the volume data with a buffer of the same dimensions.
  *
- * @return The number of channels in the volume data.
+ * The buffer is moved in, so filters can build their output in a VoxelBuffer and hand it
+ * over without a copy. Its size must match width x height x depth x channels. Any slab
+ * index built for the old data is dropped.
+ * @param newData The new voxel data, laid out like getData().
  */
-void Volume::setData(const std::vector<std::vector<unsigned char>>& newData) {
-    data = newData;
-    depth = data.size();
+void Volume::setData(VoxelBuffer newData) {
+    if (newData.size() != getVoxelCount()) {
+        std::cerr << "Error: Volume data size does not match the volume dimensions." << std::endl;
+        return;
+    }
+    data = std::move(newData);
+    slabIndex.reset(); // The summaries describe the old data
 }
 
 /**
- * @brief Sets the volume data to the new provided data.
+ * @brief Saves the volume as a series of PNG slices.
  *
- * Assigns the new data to the volume and updates the depth accordingly.
- * @param newData A vector of new data to replace the current volume data.
+ * Each slice is encoded on the worker pool.
+ * @param directoryPath The directory to write slice_<z>.png files into; created if missing.
+ * @return True if every slice was written successfully, false otherwise.
  */
 bool Volume::saveVolume(const std::string& directoryPath) const {
     fs::path dirPath(directoryPath);
@@ -162,12 +246,18 @@ bool Volume::saveVolume(const std::string& directoryPath) const {
         }
     }
 
-    for (size_t i = 0; i < data.size(); ++i) {
+    // Slices are encoded independently on the worker pool
+    std::vector<char> saved(depth, 0);
+    Parallel::parallelFor(0, depth, [&](int i) {
         std::string filePath = directoryPath + "/slice_" + std::to_string(i) + ".png";
-        if (!stbi_write_png(filePath.c_str(), width, height, channels, data[i].data(), width * channels)) {
+        saved[i] = stbi_write_png(filePath.c_str(), width, height, channels, getSlice(i).data, width * channels) != 0;
+    });
+
+    for (int i = 0; i < depth; ++i) {
+        if (!saved[i]) {
             std::cerr << "Failed to save slice " << i << std::endl;
             return false;
         }
     }
     return true;
-}
\ No newline at end of file
+}
@@ -7,15 +7,71 @@
 #ifndef VOLUME_H
 #define VOLUME_H
 
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
+// Allocator handing out cache-line aligned storage. Elements are default-initialised,
+// so sizing a buffer that is about to be overwritten does not pay for a memset.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    void construct(U* p) noexcept { ::new (static_cast<void*>(p)) U; }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+// Contiguous voxel storage: slice z, row y, column x, channel ch lives at
+// z * zStride + y * yStride + x * xStride + ch.
+using VoxelBuffer = std::vector<unsigned char, AlignedAllocator<unsigned char>>;
+
+// Lightweight non-owning view of one z slice inside a Volume.
+template <typename T>
+struct SliceView {
+    T* data;
+    int width, height, channels;
+
+    T* row(int y) const { return data + static_cast<std::size_t>(y) * width * channels; }
+    T& at(int x, int y, int ch = 0) const { return row(y)[x * channels + ch]; }
+    T& operator[](std::size_t i) const { return data[i]; }
+    std::size_t size() const { return static_cast<std::size_t>(width) * height * channels; }
+    T* begin() const { return data; }
+    T* end() const { return data + size(); }
+};
+
+class SlabIndex;
+
 class Volume {
 public:
     Volume();
+    Volume(int width, int height, int depth, int channels);
     ~Volume();
 
-    void setData(const std::vector<std::vector<unsigned char>>& newData);
+    void setData(VoxelBuffer newData);
 
     bool loadVolume(const std::string& directoryPath);
 
@@ -28,13 +84,34 @@ public:
 
     int getChannels() const;
 
-    const std::vector<std::vector<unsigned char>>& getData() const;
+    // Strides in bytes between neighbouring voxels along each axis
+    std::size_t getXStride() const { return channels; }
+    std::size_t getYStride() const { return static_cast<std::size_t>(width) * channels; }
+    std::size_t getZStride() const { return static_cast<std::size_t>(width) * height * channels; }
+    std::size_t getVoxelCount() const { return getZStride() * depth; }
+
+    std::size_t index(int x, int y, int z, int ch = 0) const {
+        return z * getZStride() + y * getYStride() + x * getXStride() + ch;
+    }
+
+    const unsigned char* getData() const;
+    unsigned char* getData();
+
+    SliceView<const unsigned char> getSlice(int z) const;
+    SliceView<unsigned char> getSlice(int z);
+
+    // Optional precomputed slab summaries used by Projection. setData() and loadVolume()
+    // drop the index; code writing through getData() must call clearSlabIndex() itself.
+    void setSlabIndex(std::shared_ptr<const SlabIndex> index) { slabIndex = std::move(index); }
+    const SlabIndex* getSlabIndex() const { return slabIndex.get(); }
+    void clearSlabIndex() { slabIndex.reset(); }
 
 private:
     void freeVolume();
 
     int width, height, depth, channels;
-    std::vector<std::vector<unsigned char>> data; // Stores volume data
+    VoxelBuffer data; // Stores volume data as one contiguous block
+    std::shared_ptr<const SlabIndex> slabIndex; // Shared by copies until either one's data changes
 };
 
-#endif // VOLUME_H
\ No newline at end of file
+#endif // VOLUME_H